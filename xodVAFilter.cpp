@@ -9,7 +9,7 @@
 //	Purpose: C++ implementation of Virtual Analog Filters
 //			 IIR Toplogy-Preserving Transform (TPT) Filters
 //			 "The Art Of VA Filter Design" - Vadim Zavalishin
-//			 VA filters: Moog Ladder 4-pole
+//			 VA filters: Moog Ladder 4-pole, State Variable 2-pole
 //
 //	Revision History: Feb 08, 2017 - initial
 //	Revision History: Mar 10, 2020 - current
@@ -43,10 +43,21 @@ void onePoleTPTFB_LP::doFilterStage_LP(float xn, float& z1fb, float& ynLP) {
 
 }
 
+// snapshot: alpha, fs, z1
+void onePoleTPTFB_LP::saveState(xodStateWriter& w) const {
+	w.put(fAlpha);
+	w.put(sampleRate);
+	w.put(z1);
+}
+
+bool onePoleTPTFB_LP::loadState(xodStateReader& r) {
+	return r.get(fAlpha) && r.get(sampleRate) && r.get(z1);
+}
+
 
 
 // *--------------------------------------------------------* //
-// *--- Stereo TPT Moog Half Ladder Low-Pass filter ---* //
+// *--- TPT Moog Ladder 4-pole Low-Pass filter ---* //
 
 
 void xodMoogLadder4P::initialize(float newSampleRate) {
@@ -59,34 +70,49 @@ void xodMoogLadder4P::initialize(float newSampleRate) {
 	G = 0;
 	K = 0;
 
-	LPF1.initialize_LP(newSampleRate);
-	LPF2.initialize_LP(newSampleRate);
-	LPF3.initialize_LP(newSampleRate);
-	LPF4.initialize_LP(newSampleRate);
+	sampleRate = newSampleRate;
+
+	guardLimit = xodGuardLimit;
+	clearGuardStats();
+
+#ifdef XODVA_PROFILE
+	prof = 0;
+#endif
+
+	reset();
 
 }
 
-void xodMoogLadder4P::setFcAndRes(float cutoff, float resonance, float sampleRate) {
+// clear the filter state, coefficients are kept (voice re-use)
+void xodMoogLadder4P::reset() {
 
-	// prewarp for BZT
-	double wd = 2*pi*cutoff;
-	double T  = 1/(double)sampleRate;
-	double wa = (2/T)*tan(wd*T/2);
-	double g  = wa*T/2;
+	z1fb_1 = 0;
+	z1fb_2 = 0;
+	z1fb_3 = 0;
+	z1fb_4 = 0;
 
-	// G - the feedforward coeff in the VA One Pole
-	float G = g/(1.0 + g);
+	LPF1.initialize_LP(sampleRate);
+	LPF2.initialize_LP(sampleRate);
+	LPF3.initialize_LP(sampleRate);
+	LPF4.initialize_LP(sampleRate);
 
-	LPF1.setAlpha_LP(G);
-	LPF2.setAlpha_LP(G);
-	LPF3.setAlpha_LP(G);
-	LPF4.setAlpha_LP(G);
+}
 
+// ladder coefficients for one cutoff / resonance - shared by the scalar and
+// multi-channel ladders so both compute bit-identical coefficients
+static void ladderCoeffs(float cutoff, float resonance, float sampleRate, ladderCoeffs_t& lc) {
 
-	fBeta1 = (G*G*G) / (1.0 + g);
-	fBeta2 = (G*G) / (1.0 + g);
-	fBeta3 = G / (1.0 + g);
-	fBeta4 = 1 / (1.0 + g);
+	// prewarp for BZT - g = wa*T/2 = tan(pi*fc/fs)
+	double g  = tan(xodClampPrewarp(pi*(double)cutoff/(double)sampleRate));
+
+	// G - the feedforward coeff in the VA One Pole
+	float G = g/(1.0 + g);
+	lc.G = G;
+
+	lc.fBeta1 = (G*G*G) / (1.0 + g);
+	lc.fBeta2 = (G*G) / (1.0 + g);
+	lc.fBeta3 = G / (1.0 + g);
+	lc.fBeta4 = 1 / (1.0 + g);
 
 
 	// calculate alpha0
@@ -94,54 +120,663 @@ void xodMoogLadder4P::setFcAndRes(float cutoff, float resonance, float sampleRat
 	// ** fixed-point implementation, K=2 requires many integer bits to prevent overflow
 	// (future enhancement -> use internal data type to handle bit-growth)
 	// currently limit K resonance to less than 2.0 to prevent overflow:
-	K = resonance;
+	float K = resonance;
 	if(K > 2.0)
 		K = 2.0;
+	if(K != K)
+		K = 0;
+	lc.K = K;
+
+	lc.fAlpha0 = 1.0 / (1.0 + K*G*G*G*G);
+
+}
 
-	fAlpha0 = 1.0 / (1.0 + K*G*G*G*G);
+// batch form of ladderCoeffs - fcNorm = fc/fs per element, SoA outputs.
+// one branch free single precision pass (onePoleTPT_calcGH for the prewarp,
+// 2 divisions per element) that the compiler vectorizes - the coefficients
+// track ladderCoeffs to a few ulp but are not bit-identical to it
+static void ladderCoeffsBatch(const float* __restrict fcNorm, const float* __restrict resonance, uint32_t n,
+							  float* __restrict G, float* __restrict fAlpha0,
+							  float* __restrict fBeta1, float* __restrict fBeta2,
+							  float* __restrict fBeta3, float* __restrict fBeta4, float* __restrict K) {
+
+	for (uint32_t l = 0; l < n; l++) {
+		float g1, h1;
+		onePoleTPT_calcGH(fcNorm[l], g1, h1);
+		float g2 = g1*g1;
+		float k = (resonance[l] > 2.0f) ? 2.0f : resonance[l];
+		k = (k == k) ? k : 0.0f;
+
+		G[l] = g1;
+		fBeta1[l] = g2*g1*h1;
+		fBeta2[l] = g2*h1;
+		fBeta3[l] = g1*h1;
+		fBeta4[l] = h1;
+		K[l] = k;
+		fAlpha0[l] = 1.0f/(1.0f + k*g2*g2);
+	}
+
+}
+
+void xodMoogLadder4P::setFcAndRes(float cutoff, float resonance, float sampleRate) {
+
+	ladderCoeffs_t lc;
+	ladderCoeffs(cutoff, resonance, sampleRate, lc);
+
+	setCoeffs(lc);
 
 
+#ifndef XODVA_QUIET
 	std::cout<<std::endl<<"TB_G: "<<G<<std::endl;
 	std::cout<<"TB_K: "<<K<<std::endl;
+#endif
 	//std::cout<<"fAlpha0 = "<<fAlpha0<<std::endl;
 	//std::cout<<"setFcAndRes_Ref: g = "<<g<<",        G = "<<G<<",        K = "<<K<<",        beta1 = "<<fBeta1<<",        beta2 = "<<fBeta2<<",        beta3 = "<<fBeta3<<std::endl;
 
 }
 
+// precomputed coefficients (ladderCoeffs / batch) - no console output
+void xodMoogLadder4P::setCoeffs(const ladderCoeffs_t& lc) {
 
-void xodMoogLadder4P::advance(float xn, float& yn) {
+	G = lc.G;
+
+	LPF1.setAlpha_LP(G);
+	LPF2.setAlpha_LP(G);
+	LPF3.setAlpha_LP(G);
+	LPF4.setAlpha_LP(G);
+
+	fBeta1 = lc.fBeta1;
+	fBeta2 = lc.fBeta2;
+	fBeta3 = lc.fBeta3;
+	fBeta4 = lc.fBeta4;
+
+	K = lc.K;
+	fAlpha0 = lc.fAlpha0;
+
+}
+
+// many ladders at once (global LFO / macro on every voice) - coefficients are
+// computed ladderBatchChunk at a time in SoA scratch, then stored per ladder
+static const uint32_t ladderBatchChunk = 8*xodSimdLanes;
+
+void xodMoogLadderSetFcAndResBatch(xodMoogLadder4P* const* ladders, const float* cutoff,
+								   const float* resonance, uint32_t count) {
+
+	alignas(32) float fcNorm[ladderBatchChunk];
+	alignas(32) float res[ladderBatchChunk];
+	alignas(32) float G[ladderBatchChunk];
+	alignas(32) float fAlpha0[ladderBatchChunk];
+	alignas(32) float fBeta1[ladderBatchChunk];
+	alignas(32) float fBeta2[ladderBatchChunk];
+	alignas(32) float fBeta3[ladderBatchChunk];
+	alignas(32) float fBeta4[ladderBatchChunk];
+	alignas(32) float K[ladderBatchChunk];
+
+	for (uint32_t v0 = 0; v0 < count; v0 += ladderBatchChunk) {
+		uint32_t n = (count - v0 < ladderBatchChunk) ? count - v0 : ladderBatchChunk;
+
+		// ladders may run at different rates
+		for (uint32_t l = 0; l < n; l++) {
+			fcNorm[l] = cutoff[v0 + l]/ladders[v0 + l]->getSampleRate();
+			res[l] = resonance[v0 + l];
+		}
+
+		ladderCoeffsBatch(fcNorm, res, n, G, fAlpha0, fBeta1, fBeta2, fBeta3, fBeta4, K);
 
-	static float SM = 0;
-	//static float SM_R = 0;
+		for (uint32_t l = 0; l < n; l++) {
+			ladderCoeffs_t lc = {G[l], fAlpha0[l], fBeta1[l], fBeta2[l], fBeta3[l], fBeta4[l], K[l]};
+			ladders[v0 + l]->setCoeffs(lc);
+		}
+	}
 
-	static float yn_LP1;
-	static float yn_LP2;
-	static float yn_LP3;
-//	static float ynR_LP2;
+}
+
+
+void xodMoogLadder4P::advance(float xn, float& yn) {
 
-	static float z1fb_1;
-	static float z1fb_2;
-	static float z1fb_3;
-	static float z1fb_4;
+	// feedback state is held per instance (previously function static -
+	// shared across every ladder, which broke polyphony)
+	float SM;
 
-//	static float z1fb_R1;
-//	static float z1fb_R2;
-//	static float z1fb_R3;
+	float yn_LP1;
+	float yn_LP2;
+	float yn_LP3;
 
+	XOD_PROF_START(tSM);
 	SM = fBeta1*z1fb_1 + fBeta2*z1fb_2 + fBeta3*z1fb_3 + fBeta4*z1fb_4;		// sum 4 internal Z1 states
+	XOD_PROF_STOP(prof, PROF_ML4P_SM, tSM);
 
+	XOD_PROF_START(tAlpha0);
 	float un = fAlpha0*(xn - K*SM);
+	XOD_PROF_STOP(prof, PROF_ML4P_ALPHA0, tAlpha0);
 
 	//std::cout<<"xnL = "<<xnL<<",	fb1 = "<<z1fb_L1<<",	fb2 = "<<z1fb_L2<<",	fb3 = "<<z1fb_L3<<",	fAlpha0 = "<<fAlpha0<<",	SM_L = "<<SM_L<<",	unL_REF = "<<unL<<std::endl;
 
+	XOD_PROF_START(tStages);
 	LPF1.doFilterStage_LP(un, z1fb_1, yn_LP1);
 	LPF2.doFilterStage_LP(yn_LP1, z1fb_2, yn_LP2);
 	LPF3.doFilterStage_LP(yn_LP2, z1fb_3, yn_LP3);
 	LPF4.doFilterStage_LP(yn_LP3, z1fb_4, yn);
+	XOD_PROF_STOP(prof, PROF_ML4P_STAGES, tStages);
 
 
 	//std::cout<<"SM_REF = "<<SM_L<<",        K_REF = "<<K<<",        unL_REF = "<<unL<<std::endl;
 
 }
 
-// *--------------------------------------------------------* //
\ No newline at end of file
+// process a block of samples (xn and yn may alias - in place)
+void xodMoogLadder4P::advanceBlock(const float* xn, float* yn, uint32_t numSamples) {
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		advance(xn[i], yn[i]);
+	}
+
+	guardBlock(yn, numSamples);
+
+}
+
+// block-level blow-up guard over the output block and the feedback registers
+// (z1fb_n mirrors the stage z1 after every sample). Inf / NaN resets the
+// ladder and zeroes the block, a finite runaway is clamped to +-guardLimit
+// returns false when the block was modified
+bool xodMoogLadder4P::guardBlock(float* yn, uint32_t numSamples) {
+
+	float st[4] = {z1fb_1, z1fb_2, z1fb_3, z1fb_4};
+	uint32_t m = xodMaxAbsBits(yn, numSamples);
+	uint32_t ms = xodMaxAbsBits(st, 4);
+	m = (ms > m) ? ms : m;
+
+	if (m <= xodAbsBits(guardLimit))
+		return true;
+
+	if (m >= xodInfBits) {
+		reset();
+		for (uint32_t i = 0; i < numSamples; i++)
+			yn[i] = 0;
+		guard.resets++;
+	} else {
+		z1fb_1 = xodClampAbs(z1fb_1, guardLimit);
+		z1fb_2 = xodClampAbs(z1fb_2, guardLimit);
+		z1fb_3 = xodClampAbs(z1fb_3, guardLimit);
+		z1fb_4 = xodClampAbs(z1fb_4, guardLimit);
+		LPF1.clampZ1_LP(guardLimit);
+		LPF2.clampZ1_LP(guardLimit);
+		LPF3.clampZ1_LP(guardLimit);
+		LPF4.clampZ1_LP(guardLimit);
+		for (uint32_t i = 0; i < numSamples; i++)
+			yn[i] = xodClampAbs(yn[i], guardLimit);
+		guard.clamps++;
+	}
+
+	return false;
+
+}
+
+// snapshot: coefficients, feedback registers, then the 4 stages
+void xodMoogLadder4P::saveState(xodStateWriter& w) const {
+
+	w.put(sampleRate);
+	w.put(fAlpha0);
+	w.put(fBeta1);
+	w.put(fBeta2);
+	w.put(fBeta3);
+	w.put(fBeta4);
+	w.put(G);
+	w.put(K);
+	w.put(z1fb_1);
+	w.put(z1fb_2);
+	w.put(z1fb_3);
+	w.put(z1fb_4);
+
+	LPF1.saveState(w);
+	LPF2.saveState(w);
+	LPF3.saveState(w);
+	LPF4.saveState(w);
+
+}
+
+// loads into a copy - the ladder is only changed by a complete, valid snapshot
+bool xodMoogLadder4P::loadState(xodStateReader& r) {
+
+	xodMoogLadder4P t(*this);
+	bool ok = r.get(t.sampleRate) && r.get(t.fAlpha0) && r.get(t.fBeta1) && r.get(t.fBeta2)
+		&& r.get(t.fBeta3) && r.get(t.fBeta4) && r.get(t.G) && r.get(t.K)
+		&& r.get(t.z1fb_1) && r.get(t.z1fb_2) && r.get(t.z1fb_3) && r.get(t.z1fb_4)
+		&& t.LPF1.loadState(r) && t.LPF2.loadState(r) && t.LPF3.loadState(r) && t.LPF4.loadState(r);
+
+	if (!ok || !(t.sampleRate > 0))
+		return false;
+
+	*this = t;
+	return true;
+}
+
+// *--------------------------------------------------------* //
+
+
+
+// *--------------------------------------------------------* //
+// *--- Multi-channel TPT Moog Ladder 4-pole Low-Pass filter ---* //
+
+void xodMoogLadder4P_MC::initialize(uint32_t newNumChannels, float newSampleRate) {
+
+	numChannels = (newNumChannels > xodSimdLanes) ? xodSimdLanes : newNumChannels;
+	sampleRate = newSampleRate;
+
+	guardLimit = xodGuardLimit;
+	clearGuardStats();
+
+	// unused lanes run with zero coefficients on zero input
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		G[l] = 0;
+		fAlpha0[l] = 0;
+		fBeta1[l] = 0;
+		fBeta2[l] = 0;
+		fBeta3[l] = 0;
+		fBeta4[l] = 0;
+		K[l] = 0;
+	}
+
+	reset();
+
+}
+
+void xodMoogLadder4P_MC::reset() {
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		z1_1[l] = 0;
+		z1_2[l] = 0;
+		z1_3[l] = 0;
+		z1_4[l] = 0;
+	}
+}
+
+// linked - every channel gets the same cutoff / resonance
+void xodMoogLadder4P_MC::setFcAndRes(float cutoff, float resonance) {
+
+	ladderCoeffs_t lc;
+	ladderCoeffs(cutoff, resonance, sampleRate, lc);
+
+	for (uint32_t ch = 0; ch < numChannels; ch++) {
+		setLaneCoeffs(ch, lc);
+	}
+
+}
+
+// per-channel - channel >= numChannels is ignored
+void xodMoogLadder4P_MC::setFcAndRes(uint32_t channel, float cutoff, float resonance) {
+
+	if (channel >= numChannels)
+		return;
+
+	ladderCoeffs_t lc;
+	ladderCoeffs(cutoff, resonance, sampleRate, lc);
+	setLaneCoeffs(channel, lc);
+
+}
+
+// per-channel batch - cutoff[numChannels], resonance[numChannels], written
+// straight into the lane coefficient arrays
+void xodMoogLadder4P_MC::setFcAndResBatch(const float* cutoff, const float* resonance) {
+
+	alignas(32) float fcNorm[xodSimdLanes];
+	float invFs = 1.0f/sampleRate;
+	for (uint32_t ch = 0; ch < numChannels; ch++)
+		fcNorm[ch] = cutoff[ch]*invFs;
+
+	ladderCoeffsBatch(fcNorm, resonance, numChannels, G, fAlpha0, fBeta1, fBeta2, fBeta3, fBeta4, K);
+
+}
+
+void xodMoogLadder4P_MC::setLaneCoeffs(uint32_t lane, const ladderCoeffs_t& lc) {
+	G[lane] = lc.G;
+	fAlpha0[lane] = lc.fAlpha0;
+	fBeta1[lane] = lc.fBeta1;
+	fBeta2[lane] = lc.fBeta2;
+	fBeta3[lane] = lc.fBeta3;
+	fBeta4[lane] = lc.fBeta4;
+	K[lane] = lc.K;
+}
+
+// one frame of xodSimdLanes channels - same arithmetic as xodMoogLadder4P::advance
+inline void xodMoogLadder4P_MC::advanceFrame(float* x) {
+
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		float SM = fBeta1[l]*z1_1[l] + fBeta2[l]*z1_2[l] + fBeta3[l]*z1_3[l] + fBeta4[l]*z1_4[l];
+		float un = fAlpha0[l]*(x[l] - K[l]*SM);
+
+		float v1 = (un - z1_1[l])*G[l];
+		float y1 = v1 + z1_1[l];
+		z1_1[l] = y1 + v1;
+
+		float v2 = (y1 - z1_2[l])*G[l];
+		float y2 = v2 + z1_2[l];
+		z1_2[l] = y2 + v2;
+
+		float v3 = (y2 - z1_3[l])*G[l];
+		float y3 = v3 + z1_3[l];
+		z1_3[l] = y3 + v3;
+
+		float v4 = (y3 - z1_4[l])*G[l];
+		x[l] = v4 + z1_4[l];
+		z1_4[l] = x[l] + v4;
+	}
+
+}
+
+// max |z1| over all lanes - unused lanes stay at 0
+uint32_t xodMoogLadder4P_MC::stateMaxBits() const {
+	uint32_t m1 = xodMaxAbsBits(z1_1, xodSimdLanes);
+	uint32_t m2 = xodMaxAbsBits(z1_2, xodSimdLanes);
+	uint32_t m3 = xodMaxAbsBits(z1_3, xodSimdLanes);
+	uint32_t m4 = xodMaxAbsBits(z1_4, xodSimdLanes);
+	m1 = (m2 > m1) ? m2 : m1;
+	m3 = (m4 > m3) ? m4 : m3;
+	return (m3 > m1) ? m3 : m1;
+}
+
+// slow path of the block guard - one lane (channel), samples y[i*stride]
+void xodMoogLadder4P_MC::guardLane(uint32_t lane, float* y, uint32_t numFrames, uint32_t stride) {
+
+	float st[4] = {z1_1[lane], z1_2[lane], z1_3[lane], z1_4[lane]};
+	uint32_t m = xodMaxAbsBits(y, numFrames, stride);
+	uint32_t ms = xodMaxAbsBits(st, 4);
+	m = (ms > m) ? ms : m;
+
+	if (m <= xodAbsBits(guardLimit))
+		return;
+
+	if (m >= xodInfBits) {
+		z1_1[lane] = 0;
+		z1_2[lane] = 0;
+		z1_3[lane] = 0;
+		z1_4[lane] = 0;
+		for (uint32_t i = 0; i < numFrames; i++)
+			y[i*stride] = 0;
+		guard.resets++;
+	} else {
+		z1_1[lane] = xodClampAbs(z1_1[lane], guardLimit);
+		z1_2[lane] = xodClampAbs(z1_2[lane], guardLimit);
+		z1_3[lane] = xodClampAbs(z1_3[lane], guardLimit);
+		z1_4[lane] = xodClampAbs(z1_4[lane], guardLimit);
+		for (uint32_t i = 0; i < numFrames; i++)
+			y[i*stride] = xodClampAbs(y[i*stride], guardLimit);
+		guard.clamps++;
+	}
+
+}
+
+// in place, numFrames frames of numChannels interleaved samples
+void xodMoogLadder4P_MC::processInterleaved(float* buf, uint32_t numFrames) {
+
+	alignas(32) float x[xodSimdLanes] = {0};
+
+	if (numChannels == xodSimdLanes) {
+		for (uint32_t i = 0; i < numFrames; i++) {
+			advanceFrame(buf + i*xodSimdLanes);
+		}
+	} else {
+		for (uint32_t i = 0; i < numFrames; i++) {
+			float* frame = buf + i*numChannels;
+			for (uint32_t ch = 0; ch < numChannels; ch++)
+				x[ch] = frame[ch];
+			advanceFrame(x);
+			for (uint32_t ch = 0; ch < numChannels; ch++)
+				frame[ch] = x[ch];
+		}
+	}
+
+	// block guard - one pass over the whole block, per lane only on a trip
+	uint32_t m = xodMaxAbsBits(buf, numFrames*numChannels);
+	uint32_t ms = stateMaxBits();
+	if (((ms > m) ? ms : m) > xodAbsBits(guardLimit)) {
+		for (uint32_t ch = 0; ch < numChannels; ch++)
+			guardLane(ch, buf + ch, numFrames, numChannels);
+	}
+
+}
+
+// in place, one buffer per channel
+void xodMoogLadder4P_MC::processPlanar(float* const* chan, uint32_t numFrames) {
+
+	alignas(32) float x[xodSimdLanes] = {0};
+
+	for (uint32_t i = 0; i < numFrames; i++) {
+		for (uint32_t ch = 0; ch < numChannels; ch++)
+			x[ch] = chan[ch][i];
+		advanceFrame(x);
+		for (uint32_t ch = 0; ch < numChannels; ch++)
+			chan[ch][i] = x[ch];
+	}
+
+	uint32_t m = stateMaxBits();
+	for (uint32_t ch = 0; ch < numChannels; ch++) {
+		uint32_t mc = xodMaxAbsBits(chan[ch], numFrames);
+		m = (mc > m) ? mc : m;
+	}
+	if (m > xodAbsBits(guardLimit)) {
+		for (uint32_t ch = 0; ch < numChannels; ch++)
+			guardLane(ch, chan[ch], numFrames, 1);
+	}
+
+}
+
+void xodMoogLadder4P_MC::saveState(xodStateWriter& w) const {
+	w.put(numChannels);
+	w.put(sampleRate);
+	w.putArray(G, xodSimdLanes);
+	w.putArray(fAlpha0, xodSimdLanes);
+	w.putArray(fBeta1, xodSimdLanes);
+	w.putArray(fBeta2, xodSimdLanes);
+	w.putArray(fBeta3, xodSimdLanes);
+	w.putArray(fBeta4, xodSimdLanes);
+	w.putArray(K, xodSimdLanes);
+	w.putArray(z1_1, xodSimdLanes);
+	w.putArray(z1_2, xodSimdLanes);
+	w.putArray(z1_3, xodSimdLanes);
+	w.putArray(z1_4, xodSimdLanes);
+}
+
+// loads into a copy - numChannels indexes the lane arrays, so nothing is
+// committed unless the whole snapshot is present and in range
+bool xodMoogLadder4P_MC::loadState(xodStateReader& r) {
+	xodMoogLadder4P_MC t(*this);
+	bool ok = r.get(t.numChannels) && r.get(t.sampleRate)
+		&& r.getArray(t.G, xodSimdLanes) && r.getArray(t.fAlpha0, xodSimdLanes)
+		&& r.getArray(t.fBeta1, xodSimdLanes) && r.getArray(t.fBeta2, xodSimdLanes)
+		&& r.getArray(t.fBeta3, xodSimdLanes) && r.getArray(t.fBeta4, xodSimdLanes)
+		&& r.getArray(t.K, xodSimdLanes)
+		&& r.getArray(t.z1_1, xodSimdLanes) && r.getArray(t.z1_2, xodSimdLanes)
+		&& r.getArray(t.z1_3, xodSimdLanes) && r.getArray(t.z1_4, xodSimdLanes);
+
+	if (!ok || t.numChannels < 1 || t.numChannels > xodSimdLanes || !(t.sampleRate > 0))
+		return false;
+
+	*this = t;
+	return true;
+}
+
+// *--------------------------------------------------------* //
+
+
+
+// *--------------------------------------------------------* //
+// *--- TPT State Variable 2-pole Filter ---* //
+
+// g, R2, h for one SVF - g is prewarped in double
+static void svfCoeffs(float cutoff, float Q, float sampleRate, float& g, float& R2, float& h) {
+
+	// Q -> 0 is infinite damping, limit it
+	if (!(Q >= 0.01))
+		Q = 0.01;
+
+	double gd = tan(xodClampPrewarp(pi*(double)cutoff/(double)sampleRate));
+	double R2d = 1.0/(double)Q;			// 2R = 1/Q
+
+	g = gd;
+	R2 = R2d;
+	h = 1.0/(1.0 + R2d*gd + gd*gd);
+
+}
+
+void xodSVF2P::setFcAndQ_SVF(float fc, float Q) {
+	svfCoeffs(fc, Q, sampleRate, g, R2, h);
+}
+
+// all 5 responses in one pass
+void xodSVF2P::processBlock_SVF(const float* xn, svfBlockOut_t& yn, uint32_t numSamples) {
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		float x = xn[i];
+		float lp, bp, hp;
+		doFilterStage_SVF(x, lp, bp, hp);
+		yn.LP[i] = lp;
+		yn.BP[i] = bp;
+		yn.HP[i] = hp;
+		yn.NOTCH[i] = lp + hp;
+		yn.PEAK[i] = lp - hp;
+	}
+
+}
+
+// single response - the output select is hoisted out of the sample loop
+template<svfType type>
+static inline float svfSelect(float lp, float bp, float hp) {
+	switch (type) {
+		case SVF_LP: return lp;
+		case SVF_BP: return bp;
+		case SVF_HP: return hp;
+		case SVF_NOTCH: return lp + hp;
+		default: return lp - hp;
+	}
+}
+
+template<svfType type>
+static void svfBlock(xodSVF2P& flt, const float* xn, float* yn, uint32_t numSamples) {
+	for (uint32_t i = 0; i < numSamples; i++) {
+		float lp, bp, hp;
+		flt.doFilterStage_SVF(xn[i], lp, bp, hp);
+		yn[i] = svfSelect<type>(lp, bp, hp);
+	}
+}
+
+void xodSVF2P::processBlock_SVF(const float* xn, float* yn, uint32_t numSamples, svfType type) {
+
+	switch (type) {
+		case SVF_LP: svfBlock<SVF_LP>(*this, xn, yn, numSamples); break;
+		case SVF_BP: svfBlock<SVF_BP>(*this, xn, yn, numSamples); break;
+		case SVF_HP: svfBlock<SVF_HP>(*this, xn, yn, numSamples); break;
+		case SVF_NOTCH: svfBlock<SVF_NOTCH>(*this, xn, yn, numSamples); break;
+		case SVF_PEAK: svfBlock<SVF_PEAK>(*this, xn, yn, numSamples); break;
+	}
+
+}
+
+// snapshot: g, 2R, h, fs, s1, s2
+void xodSVF2P::saveState(xodStateWriter& w) const {
+	w.put(g);
+	w.put(R2);
+	w.put(h);
+	w.put(sampleRate);
+	w.put(s1);
+	w.put(s2);
+}
+
+bool xodSVF2P::loadState(xodStateReader& r) {
+	return r.get(g) && r.get(R2) && r.get(h) && r.get(sampleRate) && r.get(s1) && r.get(s2);
+}
+
+
+// *--------------------------------------------------------* //
+// *--- TPT State Variable 2-pole Filter - multi-voice ---* //
+
+void xodSVF2P_MV::initialize_SVF(float newSampleRate) {
+
+	sampleRate = newSampleRate;
+
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		g[l] = 0;
+		R2[l] = 2;
+		h[l] = 1;
+	}
+
+	reset_SVF();
+
+}
+
+void xodSVF2P_MV::reset_SVF() {
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		s1[l] = 0;
+		s2[l] = 0;
+	}
+}
+
+void xodSVF2P_MV::reset_SVF(uint32_t lane) {
+	s1[lane] = 0;
+	s2[lane] = 0;
+}
+
+void xodSVF2P_MV::setFcAndQ_SVF(uint32_t lane, float fc, float Q) {
+	svfCoeffs(fc, Q, sampleRate, g[lane], R2[lane], h[lane]);
+}
+
+template<svfType type>
+static void svfBlockMV(const float* __restrict xn, float* __restrict yn, uint32_t numSamples,
+					   const float* g, const float* R2, const float* h, float* s1, float* s2) {
+
+	// state is kept in locals across the block so the lane loop stays in registers
+	float z1[xodSimdLanes], z2[xodSimdLanes];
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		z1[l] = s1[l];
+		z2[l] = s2[l];
+	}
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		const float* x = xn + i*xodSimdLanes;
+		float* y = yn + i*xodSimdLanes;
+		for (uint32_t l = 0; l < xodSimdLanes; l++) {
+			float hp = (x[l] - (R2[l] + g[l])*z1[l] - z2[l])*h[l];
+			float v1 = g[l]*hp;
+			float bp = v1 + z1[l];
+			z1[l] = bp + v1;
+			float v2 = g[l]*bp;
+			float lp = v2 + z2[l];
+			z2[l] = lp + v2;
+			y[l] = svfSelect<type>(lp, bp, hp);
+		}
+	}
+
+	for (uint32_t l = 0; l < xodSimdLanes; l++) {
+		s1[l] = z1[l];
+		s2[l] = z2[l];
+	}
+
+}
+
+// xn / yn: numSamples lane-interleaved frames of xodSimdLanes floats
+void xodSVF2P_MV::processBlock_SVF(const float* xn, float* yn, uint32_t numSamples, svfType type) {
+
+	switch (type) {
+		case SVF_LP: svfBlockMV<SVF_LP>(xn, yn, numSamples, g, R2, h, s1, s2); break;
+		case SVF_BP: svfBlockMV<SVF_BP>(xn, yn, numSamples, g, R2, h, s1, s2); break;
+		case SVF_HP: svfBlockMV<SVF_HP>(xn, yn, numSamples, g, R2, h, s1, s2); break;
+		case SVF_NOTCH: svfBlockMV<SVF_NOTCH>(xn, yn, numSamples, g, R2, h, s1, s2); break;
+		case SVF_PEAK: svfBlockMV<SVF_PEAK>(xn, yn, numSamples, g, R2, h, s1, s2); break;
+	}
+
+}
+
+void xodSVF2P_MV::saveState(xodStateWriter& w) const {
+	w.putArray(g, xodSimdLanes);
+	w.putArray(R2, xodSimdLanes);
+	w.putArray(h, xodSimdLanes);
+	w.put(sampleRate);
+	w.putArray(s1, xodSimdLanes);
+	w.putArray(s2, xodSimdLanes);
+}
+
+bool xodSVF2P_MV::loadState(xodStateReader& r) {
+	return r.getArray(g, xodSimdLanes) && r.getArray(R2, xodSimdLanes) && r.getArray(h, xodSimdLanes)
+		&& r.get(sampleRate) && r.getArray(s1, xodSimdLanes) && r.getArray(s2, xodSimdLanes);
+}
+
+// *--------------------------------------------------------* //
@@ -9,7 +9,7 @@
 //	Purpose: C++ implementation of Virtual Analog Filters
 //			 IIR Toplogy-Preserving Transform (TPT) Filters
 //			 "The Art Of VA Filter Design" - Vadim Zavalishin
-//			 VA filters: Moog Ladder 4-pole
+//			 VA filters: Moog Ladder 4-pole, State Variable 2-pole
 //
 //	Revision History: Feb 08, 2017 - initial
 //	Revision History: Mar 10, 2020 - current
@@ -23,8 +23,10 @@
 
 #include <iostream>
 #include <math.h>
+#include <cstdint>
 
 #include "xodVAFilter_base.h"
+#include "xodVAFilter_profile.h"
 
 
 // *--------------------------------------------------------* //
@@ -47,6 +49,10 @@ public:
 
 	void setAlpha_LP(float alpha);
 	void doFilterStage_LP(float xn, float& z1fb, float& ynLP);
+	inline void clampZ1_LP(float limit) {z1 = xodClampAbs(z1, limit);}
+
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
 };
 
 
@@ -132,7 +138,20 @@ public:
 
 
 // *--------------------------------------------------------* //
-// *--- Stereo Moog Ladder 4-pole Filter ---* //
+// *--- Moog Ladder 4-pole Filter ---* //
+
+// ladder coefficient set - G, feedback betas, input scale alpha0, resonance K
+struct ladderCoeffs_t {
+	float G;
+	float fAlpha0;
+	float fBeta1;
+	float fBeta2;
+	float fBeta3;
+	float fBeta4;
+	float K;
+};
+
+// mono - see xodMoogLadder4P_MC for stereo / multi-channel
 
 class xodMoogLadder4P {
 public:
@@ -158,10 +177,218 @@ protected:
 
 	float K;
 
+	// feedback state - z-1 register of each stage
+	float z1fb_1;
+	float z1fb_2;
+	float z1fb_3;
+	float z1fb_4;
+
+	// block-level blow-up guard
+	float guardLimit;
+	xodGuardStats guard;
+
+#ifdef XODVA_PROFILE
+	// per-section cycle histograms - per instance, or shared by a bank
+	xodCycleProfile* prof;
+#endif
+
 public:
+#ifdef XODVA_PROFILE
+	void setProfile(xodCycleProfile* p) {prof = p;}
+#endif
+
 	void initialize(float newSampleRate);
+	void reset();
+	float getSampleRate() const {return sampleRate;}
 	void setFcAndRes(float cutoff, float resonance, float sampleRate);
+	void setCoeffs(const ladderCoeffs_t& lc);
 	void advance(float xn, float& yn);
+	void advanceBlock(const float* xn, float* yn, uint32_t numSamples);
+
+	// advanceBlock guards every block; callers of advance() can guard their own
+	bool guardBlock(float* yn, uint32_t numSamples);
+	void setGuardLimit(float limit) {guardLimit = limit;}
+	const xodGuardStats& getGuardStats() const {return guard;}
+	void clearGuardStats() {guard.resets = 0; guard.clamps = 0;}
+
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+// vectorized coefficient recompute for many ladders (global LFO / macro) -
+// single precision, no console output; ladder i gets cutoff[i], resonance[i]
+// at its own sample rate. see also xodMoogLadder4P_MC::setFcAndResBatch,
+// xodMoogLadderVoicePool::setFcAndResBatch
+void xodMoogLadderSetFcAndResBatch(xodMoogLadder4P* const* ladders, const float* cutoff,
+								   const float* resonance, uint32_t count);
+
+
+// *--------------------------------------------------------* //
+// *--- Multi-channel Moog Ladder 4-pole Filter ---* //
+
+// up to xodSimdLanes channels (stereo .. 7.1) packed into the lanes of one
+// SoA ladder - a frame of all channels is one vector pass, so stereo costs
+// the same as mono. Host buffers are processed in place, interleaved or
+// planar, without de-interleave scratch copies. Coefficients are linked
+// (one cutoff for all channels) or per channel.
+
+class xodMoogLadder4P_MC {
+public:
+
+protected:
+	uint32_t numChannels;
+	float sampleRate;	// fs
+
+	// per-lane coefficients
+	alignas(32) float G[xodSimdLanes];
+	alignas(32) float fAlpha0[xodSimdLanes];
+	alignas(32) float fBeta1[xodSimdLanes];
+	alignas(32) float fBeta2[xodSimdLanes];
+	alignas(32) float fBeta3[xodSimdLanes];
+	alignas(32) float fBeta4[xodSimdLanes];
+	alignas(32) float K[xodSimdLanes];
+
+	// per-lane z-1 register of each stage
+	alignas(32) float z1_1[xodSimdLanes];
+	alignas(32) float z1_2[xodSimdLanes];
+	alignas(32) float z1_3[xodSimdLanes];
+	alignas(32) float z1_4[xodSimdLanes];
+
+	// block-level blow-up guard - bad lanes recover on their own
+	float guardLimit;
+	xodGuardStats guard;
+
+	void setLaneCoeffs(uint32_t lane, const ladderCoeffs_t& lc);
+	inline void advanceFrame(float* x);
+	uint32_t stateMaxBits() const;
+	void guardLane(uint32_t lane, float* y, uint32_t numFrames, uint32_t stride);
+
+public:
+	void initialize(uint32_t newNumChannels, float newSampleRate);
+	void reset();
+	uint32_t getNumChannels() const {return numChannels;}
+
+	void setFcAndRes(float cutoff, float resonance);
+	void setFcAndRes(uint32_t channel, float cutoff, float resonance);
+	void setFcAndResBatch(const float* cutoff, const float* resonance);
+
+	void processInterleaved(float* buf, uint32_t numFrames);
+	void processPlanar(float* const* chan, uint32_t numFrames);
+
+	void setGuardLimit(float limit) {guardLimit = limit;}
+	const xodGuardStats& getGuardStats() const {return guard;}
+	void clearGuardStats() {guard.resets = 0; guard.clamps = 0;}
+
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+// *--------------------------------------------------------* //
+
+
+
+// *--------------------------------------------------------* //
+// *--- TPT State Variable 2-pole Filter ---* //
+
+// 12 dB/oct resonant zero-delay-feedback SVF - Zavalishin ch.4
+// two TPT integrators (same as onePoleTPT_LPHP) in one resolved loop
+// all outputs are produced by a single pass:
+//		LP, BP, HP, NOTCH = LP + HP, PEAK = LP - HP
+
+enum svfType {
+	SVF_LP = 0,
+	SVF_BP,
+	SVF_HP,
+	SVF_NOTCH,
+	SVF_PEAK
+};
+
+// block output buffers - one per SVF response
+struct svfBlockOut_t {
+	float* LP;
+	float* BP;
+	float* HP;
+	float* NOTCH;
+	float* PEAK;
+};
+
+class xodSVF2P {
+public:
+
+protected:
+	// controls
+	float g;			// prewarped integrator gain - tan(pi*fc/fs)
+	float R2;			// 2 * damping (R = 1/2Q)
+	float h;			// 1 / (1 + 2Rg + g^2) - resolves the zero-delay loop
+	float sampleRate;	// fs
+
+	// state
+	float s1;			// z-1 register - BP integrator
+	float s2;			// z-1 register - LP integrator
+
+public:
+	inline void initialize_SVF(float newSampleRate) {
+		sampleRate = newSampleRate;
+		g = 0;
+		R2 = 2;
+		h = 1;
+		s1 = 0;
+		s2 = 0;
+	}
+
+	float getSampleRate_SVF(){return sampleRate;}
+	void setFcAndQ_SVF(float fc, float Q);
+
+	inline void doFilterStage_SVF(float xn, float& ynLP, float& ynBP, float& ynHP) {
+		ynHP = (xn - (R2 + g)*s1 - s2)*h;
+		float v1 = g*ynHP;
+		ynBP = v1 + s1;
+		s1 = ynBP + v1;
+		float v2 = g*ynBP;
+		ynLP = v2 + s2;
+		s2 = ynLP + v2;
+	}
+
+	void processBlock_SVF(const float* xn, svfBlockOut_t& yn, uint32_t numSamples);
+	void processBlock_SVF(const float* xn, float* yn, uint32_t numSamples, svfType type);
+
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+
+// *--------------------------------------------------------* //
+// *--- TPT State Variable 2-pole Filter - multi-voice ---* //
+
+// xodSimdLanes independent SVF voices in SoA layout, each voice with its own
+// cutoff and Q. Block buffers are lane-interleaved frames:
+//		xn[i*xodSimdLanes + lane]
+// so every lane loop maps onto one vector op. Unused lanes cost nothing extra.
+
+class xodSVF2P_MV {
+public:
+
+protected:
+	// controls
+	alignas(32) float g[xodSimdLanes];
+	alignas(32) float R2[xodSimdLanes];
+	alignas(32) float h[xodSimdLanes];
+	float sampleRate;	// fs
+
+	// state
+	alignas(32) float s1[xodSimdLanes];
+	alignas(32) float s2[xodSimdLanes];
+
+public:
+	void initialize_SVF(float newSampleRate);
+	void reset_SVF();
+	void reset_SVF(uint32_t lane);
+	void setFcAndQ_SVF(uint32_t lane, float fc, float Q);
+
+	void processBlock_SVF(const float* xn, float* yn, uint32_t numSamples, svfType type);
+
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
 };
 
 // *--------------------------------------------------------* //
@@ -0,0 +1,190 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_allpass.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 N-stage 1-pole TPT All-Pass cascade (phaser core)
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <math.h>
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter_allpass.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- N-stage All-Pass Cascade ---* //
+
+const uint32_t xodAllPassCascade::maxStages;
+const uint32_t xodAllPassCascade::maxLanes;
+
+void xodAllPassCascade::initialize(uint32_t newNumStages, float newSampleRate) {
+
+	numStages = newNumStages;
+	if (numStages < 1)
+		numStages = 1;
+	if (numStages > maxStages)
+		numStages = maxStages;
+	numLanes = ((numStages + xodSimdLanes - 1)/xodSimdLanes)*xodSimdLanes;
+
+	sampleRate = newSampleRate;
+	baseFc = 1000;
+	spread = 1;
+	depth = 0;
+	feedback = 0;
+	mix = 0.5;
+
+	// padding stages keep G = 0 - their outputs are never read
+	for (uint32_t k = 0; k < maxLanes; k++)
+		G[k] = 0;
+
+	reset();
+	setStageG(0);
+
+}
+
+void xodAllPassCascade::reset() {
+
+	for (uint32_t k = 0; k < maxLanes; k++) {
+		z1[k] = 0;
+		pipe[k] = 0;
+		dryDelay[k] = 0;
+	}
+	fbSig = 0;
+	dryPos = 0;
+
+}
+
+void xodAllPassCascade::setCutoffs(float newBaseFc, float newSpread) {
+	baseFc = newBaseFc;
+	spread = newSpread;
+	setStageG(0);
+}
+
+void xodAllPassCascade::modulate(float lfo) {
+	setStageG(lfo);
+}
+
+// fc_k = baseFc * spread^k * 2^(depth*lfo), kept below 0.49 fs
+void xodAllPassCascade::setStageG(float lfo) {
+
+	double piT = pi/(double)sampleRate;
+	double fcMax = 0.49*sampleRate;
+	double fc = baseFc*pow(2.0, (double)depth*lfo);
+
+	for (uint32_t k = 0; k < numStages; k++) {
+		double fck = (fc < fcMax) ? fc : fcMax;
+		G[k] = onePoleTPT_calcG(fck, piT);
+		fc *= spread;
+	}
+
+}
+
+// wavefront pipelined cascade - stage k processes sample n-k on step n
+void xodAllPassCascade::processBlock(const float* xn, float* yn, uint32_t numSamples) {
+
+	const uint32_t last = numStages - 1;
+	alignas(32) float in[maxLanes];
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+
+		// stage inputs: new sample + feedback into stage 0, previous step's
+		// outputs shifted one stage down the chain
+		in[0] = xn[i] + feedback*fbSig;
+		for (uint32_t k = 1; k < numLanes; k++)
+			in[k] = pipe[k - 1];
+
+		// all stages are independent within the step
+		for (uint32_t k = 0; k < numLanes; k++) {
+			float v = (in[k] - z1[k])*G[k];
+			float LP = v + z1[k];
+			float HP = in[k] - LP;
+			pipe[k] = LP - HP;
+			z1[k] = LP + v;
+		}
+
+		float wet = pipe[last];
+		fbSig = wet;
+
+		// dry delayed by the pipeline latency
+		float dry = xn[i];
+		if (last > 0) {
+			float d = dryDelay[dryPos];
+			dryDelay[dryPos] = dry;
+			dryPos = (dryPos + 1 == last) ? 0 : dryPos + 1;
+			dry = d;
+		}
+
+		yn[i] = (1 - mix)*dry + mix*wet;
+	}
+
+}
+
+// reference - serial cascade, exact 1-sample feedback, no latency
+void xodAllPassCascade::processBlockSerial(const float* xn, float* yn, uint32_t numSamples) {
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+
+		float x = xn[i] + feedback*fbSig;
+		for (uint32_t k = 0; k < numStages; k++) {
+			float v = (x - z1[k])*G[k];
+			float LP = v + z1[k];
+			float HP = x - LP;
+			x = LP - HP;
+			z1[k] = LP + v;
+		}
+		fbSig = x;
+
+		yn[i] = (1 - mix)*xn[i] + mix*x;
+	}
+
+}
+
+void xodAllPassCascade::saveState(xodStateWriter& w) const {
+
+	w.put(numStages);
+	w.put(sampleRate);
+	w.put(baseFc);
+	w.put(spread);
+	w.put(depth);
+	w.put(feedback);
+	w.put(mix);
+	w.putArray(G, maxLanes);
+	w.putArray(z1, maxLanes);
+	w.putArray(pipe, maxLanes);
+	w.put(fbSig);
+	w.putArray(dryDelay, maxLanes);
+	w.put(dryPos);
+
+}
+
+// loads into a copy - committed only when the stage count and the dry delay
+// position are in range
+bool xodAllPassCascade::loadState(xodStateReader& r) {
+
+	xodAllPassCascade t(*this);
+	bool ok = r.get(t.numStages) && r.get(t.sampleRate) && r.get(t.baseFc) && r.get(t.spread)
+		&& r.get(t.depth) && r.get(t.feedback) && r.get(t.mix)
+		&& r.getArray(t.G, maxLanes) && r.getArray(t.z1, maxLanes) && r.getArray(t.pipe, maxLanes)
+		&& r.get(t.fbSig) && r.getArray(t.dryDelay, maxLanes) && r.get(t.dryPos);
+
+	if (!ok || t.numStages < 1 || t.numStages > maxStages || (t.dryPos != 0 && t.dryPos + 1 >= t.numStages))
+		return false;
+
+	t.numLanes = ((t.numStages + xodSimdLanes - 1)/xodSimdLanes)*xodSimdLanes;
+	*this = t;
+	return true;
+}
+
+// *---------------------------------------------------------------------------* //
@@ -0,0 +1,96 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_allpass.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 N-stage 1-pole TPT All-Pass cascade (phaser core)
+//			 wavefront pipelined - stage k works on sample n-k
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_ALLPASS_H__
+#define __XODVAFILTER_ALLPASS_H__
+
+
+#include <cstdint>
+
+#include "xodVAFilter_base.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- N-stage All-Pass Cascade ---* //
+
+// A serial cascade is one long dependency chain per sample. Pipelined, stage
+// k consumes the output stage k-1 produced on the previous sample, so all
+// stages of one step are independent and the stage loop vectorizes.
+//
+//	- wet output is delayed by getLatency() = numStages-1 samples, the dry
+//	  path is delayed to match before the mix
+//	- feedback is taken from the pipelined output, so the loop delay is
+//	  numStages samples instead of 1 - use processBlockSerial() where the
+//	  exact 1-sample feedback loop matters
+//	- stage k runs at baseFc*spread^k, all cutoffs move together from one
+//	  LFO value per block: fc_k * 2^(depth*lfo)
+
+class xodAllPassCascade {
+public:
+
+	static const uint32_t maxStages = 24;
+	// stage arrays padded to whole lane groups
+	static const uint32_t maxLanes = ((maxStages + xodSimdLanes - 1)/xodSimdLanes)*xodSimdLanes;
+
+protected:
+	// controls
+	uint32_t numStages;
+	uint32_t numLanes;		// numStages rounded up to xodSimdLanes
+	float sampleRate;	// fs
+	float baseFc;
+	float spread;
+	float depth;		// modulation depth (octaves)
+	float feedback;
+	float mix;			// 0 = dry, 1 = wet
+
+	alignas(32) float G[maxLanes];		// per stage cutoff
+	alignas(32) float z1[maxLanes];		// per stage z-1 register
+	alignas(32) float pipe[maxLanes];	// stage outputs of the previous step
+
+	float fbSig;		// feedback signal (pipelined or serial output)
+
+	// dry delay matching the pipeline latency
+	float dryDelay[maxLanes];
+	uint32_t dryPos;
+
+	void setStageG(float lfo);
+
+public:
+	void initialize(uint32_t newNumStages, float newSampleRate);
+	void reset();
+
+	uint32_t getNumStages() const {return numStages;}
+	uint32_t getLatency() const {return numStages - 1;}
+
+	void setCutoffs(float newBaseFc, float newSpread);
+	void setDepth(float octaves) {depth = octaves;}
+	void setFeedback(float fb) {feedback = fb;}
+	void setMix(float newMix) {mix = newMix;}
+
+	// lfo in [-1, 1] - recompute all stage cutoffs once per block
+	void modulate(float lfo);
+
+	void processBlock(const float* xn, float* yn, uint32_t numSamples);
+	void processBlockSerial(const float* xn, float* yn, uint32_t numSamples);
+
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+
+
+#endif // __XODVAFILTER_ALLPASS_H__
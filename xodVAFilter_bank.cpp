@@ -0,0 +1,216 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_bank.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 large SoA 1-pole TPT filterbank (1k - 10k bands / smoothers)
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <math.h>
+#include <vector>
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter_bank.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- 1-pole TPT Filterbank ---* //
+
+const uint32_t xodOnePoleBank::bankAlign;
+const uint32_t xodOnePoleBank::bankPad;
+const uint32_t xodOnePoleBank::tileBands;
+const uint32_t xodOnePoleBank::maxBands;
+std::atomic<uint32_t> xodOnePoleBank::defaultTile(xodOnePoleBank::tileBands);
+
+xodOnePoleBank::xodOnePoleBank() : numBands(0), stride(0), tile(tileBands), sampleRate(0), G(0), z1(0) {
+}
+
+xodOnePoleBank::~xodOnePoleBank() {
+	free(G);
+	free(z1);
+}
+
+bool xodOnePoleBank::initialize(uint32_t newNumBands, float newSampleRate) {
+
+	free(G);
+	free(z1);
+	G = 0;
+	z1 = 0;
+	numBands = 0;
+	stride = 0;
+	sampleRate = newSampleRate;
+
+	if (newNumBands > maxBands)
+		return false;
+
+	uint32_t newStride = ((newNumBands + bankPad - 1)/bankPad)*bankPad;
+	if (newStride == 0)
+		newStride = bankPad;
+
+	// stride*4 bytes is a multiple of bankAlign
+	size_t bytes = (size_t)newStride*sizeof(float);
+	G = (float*)aligned_alloc(bankAlign, bytes);
+	z1 = (float*)aligned_alloc(bankAlign, bytes);
+	if (!G || !z1) {
+		free(G);
+		free(z1);
+		G = 0;
+		z1 = 0;
+		return false;
+	}
+	numBands = newNumBands;
+	stride = newStride;
+	tile = getDefaultTileBands();
+
+	// padding bands run with G = 0 - output stays 0 (LP)
+	for (uint32_t k = 0; k < stride; k++)
+		G[k] = 0;
+
+	reset();
+	return true;
+
+}
+
+void xodOnePoleBank::setTileBands(uint32_t bands) {
+	tile = ((bands + bankPad - 1)/bankPad)*bankPad;
+	if (tile == 0)
+		tile = bankPad;
+}
+
+void xodOnePoleBank::setDefaultTileBands(uint32_t bands) {
+	uint32_t t = ((bands + bankPad - 1)/bankPad)*bankPad;
+	defaultTile.store(t ? t : bankPad, std::memory_order_relaxed);
+}
+
+void xodOnePoleBank::reset() {
+	for (uint32_t k = 0; k < stride; k++)
+		z1[k] = 0;
+}
+
+void xodOnePoleBank::setFc(uint32_t band, float fc) {
+	G[band] = onePoleTPT_calcG(fc, pi/(double)sampleRate);
+}
+
+void xodOnePoleBank::setFc(const float* fc) {
+	double piT = pi/(double)sampleRate;
+	for (uint32_t k = 0; k < numBands; k++)
+		G[k] = onePoleTPT_calcG(fc[k], piT);
+}
+
+// per-block cutoff modulation of every band - onePoleTPT_calcGH in one
+// vectorized pass instead of a libm tan per band
+void xodOnePoleBank::setFcBatch(const float* fc) {
+	float invFs = 1.0f/sampleRate;
+	for (uint32_t k = 0; k < numBands; k++) {
+		float g, h;
+		onePoleTPT_calcGH(fc[k]*invFs, g, h);
+		G[k] = g;
+	}
+}
+
+void xodOnePoleBank::setG(const float* newG) {
+	for (uint32_t k = 0; k < numBands; k++)
+		G[k] = newG[k];
+}
+
+// TPT 1-pole over bands [b0, b1) for one sample - x is a scalar or per band
+template<bankOutType type, bool perBand>
+static inline void bankStep(const float* __restrict x, float* __restrict y,
+							const float* __restrict G, float* __restrict z1, uint32_t b0, uint32_t b1) {
+	for (uint32_t k = b0; k < b1; k++) {
+		float xk = perBand ? x[k] : x[0];
+		float v = (xk - z1[k])*G[k];
+		float lp = v + z1[k];
+		z1[k] = lp + v;
+		y[k] = (type == BANK_LP) ? lp : xk - lp;
+	}
+}
+
+template<bankOutType type, bool perBand>
+static void bankBlock(const float* xn, float* yn, uint32_t numSamples, uint32_t stride, uint32_t tile,
+					  const float* G, float* z1) {
+
+	// tile over bands - a tile's G / z1 stay in L1 for the whole block
+	for (uint32_t b0 = 0; b0 < stride; b0 += tile) {
+		uint32_t b1 = (b0 + tile < stride) ? b0 + tile : stride;
+		for (uint32_t i = 0; i < numSamples; i++) {
+			const float* x = perBand ? xn + (size_t)i*stride : xn + i;
+			bankStep<type, perBand>(x, yn + (size_t)i*stride, G, z1, b0, b1);
+		}
+	}
+
+}
+
+void xodOnePoleBank::processSample(float xn, float* yn, bankOutType type) {
+	if (type == BANK_LP)
+		bankStep<BANK_LP, false>(&xn, yn, G, z1, 0, stride);
+	else
+		bankStep<BANK_HP, false>(&xn, yn, G, z1, 0, stride);
+}
+
+void xodOnePoleBank::processSampleSmooth(const float* xn, float* yn, bankOutType type) {
+	if (type == BANK_LP)
+		bankStep<BANK_LP, true>(xn, yn, G, z1, 0, stride);
+	else
+		bankStep<BANK_HP, true>(xn, yn, G, z1, 0, stride);
+}
+
+void xodOnePoleBank::processBlock(const float* xn, float* yn, uint32_t numSamples, bankOutType type) {
+	if (type == BANK_LP)
+		bankBlock<BANK_LP, false>(xn, yn, numSamples, stride, tile, G, z1);
+	else
+		bankBlock<BANK_HP, false>(xn, yn, numSamples, stride, tile, G, z1);
+}
+
+void xodOnePoleBank::processBlockSmooth(const float* xn, float* yn, uint32_t numSamples, bankOutType type) {
+	if (type == BANK_LP)
+		bankBlock<BANK_LP, true>(xn, yn, numSamples, stride, tile, G, z1);
+	else
+		bankBlock<BANK_HP, true>(xn, yn, numSamples, stride, tile, G, z1);
+}
+
+// snapshot: numBands, fs, G[numBands], z1[numBands]
+void xodOnePoleBank::saveState(xodStateWriter& w) const {
+	w.put(numBands);
+	w.put(sampleRate);
+	w.putArray(G, numBands);
+	w.putArray(z1, numBands);
+}
+
+// validated and read into temporaries first - a corrupt snapshot leaves the bank untouched
+bool xodOnePoleBank::loadState(xodStateReader& r) {
+	uint32_t bands = 0;
+	float fs = 0;
+	if (!r.get(bands) || !r.get(fs))
+		return false;
+	if (bands > maxBands || !(fs > 0) || r.getRemaining() < (size_t)2*sizeof(float)*bands)
+		return false;
+
+	std::vector<float> g(bands), z(bands);
+	if (!r.getArray(g.data(), bands) || !r.getArray(z.data(), bands))
+		return false;
+
+	if ((bands != numBands || G == 0) && !initialize(bands, fs))
+		return false;
+	sampleRate = fs;
+	for (uint32_t k = 0; k < bands; k++) {
+		G[k] = g[k];
+		z1[k] = z[k];
+	}
+	return true;
+}
+
+// *---------------------------------------------------------------------------* //
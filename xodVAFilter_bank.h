@@ -0,0 +1,121 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_bank.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 large SoA 1-pole TPT filterbank (1k - 10k bands / smoothers)
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	state is 2 packed float arrays - G[] and z1[] - 64 byte aligned (AVX-512)
+//	and padded to a multiple of 16 bands; the sample rate is shared.
+//
+//		bytes / band = 8  (G + z1)   vs 12 for an onePoleTPT_* object
+//		10k bands    = 80 KB         - stays resident in L2
+//
+//	throughput (bands x samples per ms on one core) is reported by the
+//	harness: xodVAFilter -t BANK -n <samples>
+//	measured (gcc 12, -O3, AVX-512 Xeon, 64 sample blocks): 1.7e6 - 2.2e6
+//	bands/core/ms with a shared input, 1.3e6 - 1.4e6 with per-band inputs.
+//	at 10k bands the sample-major output stream (4 bytes/band/sample), not
+//	the filter arithmetic, is the limit.
+//
+//	block processing is tiled: a tile of tileBands bands (8 KB of state)
+//	runs through the whole block before the next tile, so the state stays in
+//	L1 and the input / output streams are read / written with unit stride.
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_BANK_H__
+#define __XODVAFILTER_BANK_H__
+
+
+#include <atomic>
+#include <cstdint>
+
+#include "xodVAFilter_base.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- 1-pole TPT Filterbank ---* //
+
+enum bankOutType {
+	BANK_LP = 0,
+	BANK_HP
+};
+
+class xodOnePoleBank {
+public:
+
+	static const uint32_t bankAlign = 64;		// bytes - one AVX-512 register / cache line
+	static const uint32_t bankPad = 16;			// bands - floats per bankAlign
+	static const uint32_t tileBands = 1024;		// default bands per block tile
+	static const uint32_t maxBands = 1u << 24;	// 128 MB of state
+
+protected:
+	uint32_t numBands;
+	uint32_t stride;		// numBands padded to bankPad
+	uint32_t tile;			// bands per block tile - tileBands or tuned (xodVAFilter_tune.h)
+	float sampleRate;	// fs - shared by every band
+
+	float* G;			// [stride] cutoff
+	float* z1;			// [stride] z-1 register
+
+	static std::atomic<uint32_t> defaultTile;
+
+public:
+	xodOnePoleBank();
+	~xodOnePoleBank();
+	xodOnePoleBank(const xodOnePoleBank&) = delete;
+	xodOnePoleBank& operator=(const xodOnePoleBank&) = delete;
+
+	// allocates - call from the setup thread. false (an empty bank) when
+	// newNumBands > maxBands or the allocation fails. the tile starts at the
+	// process default
+	bool initialize(uint32_t newNumBands, float newSampleRate);
+	void reset();
+
+	uint32_t getNumBands() const {return numBands;}
+	uint32_t getStride() const {return stride;}
+	uint32_t getTileBands() const {return tile;}
+	void setTileBands(uint32_t bands);		// rounded to a multiple of bankPad
+
+	// tile of banks initialized from now on - tileBands, or the tuned
+	// bankTile once xodTuneGet() has run
+	static void setDefaultTileBands(uint32_t bands);
+	static uint32_t getDefaultTileBands() {return defaultTile.load(std::memory_order_relaxed);}
+	float getSampleRate() const {return sampleRate;}
+	uint32_t getBytesPerBand() const {return 2*sizeof(float);}
+
+	void setFc(uint32_t band, float fc);
+	void setFc(const float* fc);			// [numBands]
+	void setG(const float* newG);			// [numBands] precomputed big G
+	void setFcBatch(const float* fc);		// [numBands] vectorized single precision G (modulation)
+
+	// one input sample to every band - y[stride]
+	void processSample(float xn, float* yn, bankOutType type);
+
+	// one input sample per band (smoothers) - xn[stride], yn[stride]
+	void processSampleSmooth(const float* xn, float* yn, bankOutType type);
+
+	// shared input block, yn is sample-major: yn[i*stride + band]
+	void processBlock(const float* xn, float* yn, uint32_t numSamples, bankOutType type);
+
+	// per-band input block, xn and yn sample-major: xn[i*stride + band]
+	void processBlockSmooth(const float* xn, float* yn, uint32_t numSamples, bankOutType type);
+
+	// false on a corrupt snapshot (bad band count / sample rate, truncated) - the bank is untouched
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+
+
+#endif // __XODVAFILTER_BANK_H__
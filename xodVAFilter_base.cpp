@@ -26,17 +26,14 @@
 // *--- 1-pole TPT Low-Pass Model ---* //
 
 void onePoleTPT_LP::setFc_LP(float fc) {
-	// pre-warp the cutoff - bilinear-transform filters
-	float wd = 2*pi*fc;
-	float T = 1/sampleRate;
-	float wa = (2/T)*tan(wd*T/2);
-	float g = wa*T/2;
-
+	// prewarp the cutoff - bilinear-transform filters
 	// calculate big G value - Zavalishin p46 (the Art of VA Design)
 	// 0.0 < G < 1.0 (from simulation)
-	G = g/(1.0 + g);
+	G = onePoleTPT_calcG(fc, pi/(double)sampleRate);
 
+#ifndef XODVA_QUIET
 	std::cout<<"TPT G = "<<G<<std::endl;
+#endif
 }
 
 void onePoleTPT_LP::doFilterStage_LP(float xn, float& ynLP) {
@@ -46,22 +43,30 @@ void onePoleTPT_LP::doFilterStage_LP(float xn, float& ynLP) {
 
 }
 
+// snapshot: G, fs, z1
+void onePoleTPT_LP::saveState(xodStateWriter& w) const {
+	w.put(G);
+	w.put(sampleRate);
+	w.put(z1);
+}
+
+bool onePoleTPT_LP::loadState(xodStateReader& r) {
+	return r.get(G) && r.get(sampleRate) && r.get(z1);
+}
+
 
 // *---------------------------------------------------------------------------* //
 // *--- 1-pole TPT High-Pass Model ---* //
 
 void onePoleTPT_HP::setFc_HP(float fc) {
 	// prewarp the cutoff - bilinear-transform filters
-	float wd = 2*pi*fc;
-	float T = 1/sampleRate;
-	float wa = (2/T)*tan(wd*T/2);
-	float g = wa*T/2;
-
 	// calculate big G value - Zavalishin p46 (the Art of VA Design)
 	// 0.0 < G < 1.0 (from simulation)
-	G = g/(1.0 + g);
+	G = onePoleTPT_calcG(fc, pi/(double)sampleRate);
 
+#ifndef XODVA_QUIET
 	std::cout<<"TPT G = "<<G<<std::endl;
+#endif
 }
 
 void onePoleTPT_HP::doFilterStage_HP(float xn, float& ynHP) {
@@ -72,22 +77,30 @@ void onePoleTPT_HP::doFilterStage_HP(float xn, float& ynHP) {
 
 }
 
+// snapshot: G, fs, z1
+void onePoleTPT_HP::saveState(xodStateWriter& w) const {
+	w.put(G);
+	w.put(sampleRate);
+	w.put(z1);
+}
+
+bool onePoleTPT_HP::loadState(xodStateReader& r) {
+	return r.get(G) && r.get(sampleRate) && r.get(z1);
+}
+
 
 // *---------------------------------------------------------------------------* //
 // *--- 1-pole TPT Low-Pass + High-Pass Model ---* //
 
 void onePoleTPT_LPHP::setFc_LPHP(float fc) {
 	// prewarp the cutoff - bilinear-transform filters
-	float wd = 2*pi*fc;
-	float T = 1/sampleRate;
-	float wa = (2/T)*tan(wd*T/2);
-	float g = wa*T/2;
-
 	// calculate big G value - Zavalishin p46 (the Art of VA Design)
 	// 0.0 < G < 1.0 (from simulation)
-	G = g/(1.0 + g);
+	G = onePoleTPT_calcG(fc, pi/(double)sampleRate);
 
+#ifndef XODVA_QUIET
 	std::cout<<"TPT G = "<<G<<std::endl;
+#endif
 }
 
 void onePoleTPT_LPHP::doFilterStage_LPHP(float xn, float& ynLP, float& ynHP) {
@@ -98,22 +111,30 @@ void onePoleTPT_LPHP::doFilterStage_LPHP(float xn, float& ynLP, float& ynHP) {
 
 }
 
+// snapshot: G, fs, z1
+void onePoleTPT_LPHP::saveState(xodStateWriter& w) const {
+	w.put(G);
+	w.put(sampleRate);
+	w.put(z1);
+}
+
+bool onePoleTPT_LPHP::loadState(xodStateReader& r) {
+	return r.get(G) && r.get(sampleRate) && r.get(z1);
+}
+
 
 // *---------------------------------------------------------------------------* //
 // *--- 1-pole TPT All-Pass Model ---* //
 
 void onePoleTPT_AP::setFc_AP(float fc) {
 	// prewarp the cutoff - bilinear-transform filters
-	float wd = 2*pi*fc;
-	float T = 1/sampleRate;
-	float wa = (2/T)*tan(wd*T/2);
-	float g = wa*T/2;
-
 	// calculate big G value - Zavalishin p46 (the Art of VA Design)
 	// 0.0 < G < 1.0 (from simulation)
-	G = g/(1.0 + g);
+	G = onePoleTPT_calcG(fc, pi/(double)sampleRate);
 
+#ifndef XODVA_QUIET
 	std::cout<<"TPT G = "<<G<<std::endl;
+#endif
 }
 
 void onePoleTPT_AP::doFilterStage_AP(float xn, float& ynAP) {
@@ -125,4 +146,15 @@ void onePoleTPT_AP::doFilterStage_AP(float xn, float& ynAP) {
 
 }
 
+// snapshot: G, fs, z1
+void onePoleTPT_AP::saveState(xodStateWriter& w) const {
+	w.put(G);
+	w.put(sampleRate);
+	w.put(z1);
+}
+
+bool onePoleTPT_AP::loadState(xodStateReader& r) {
+	return r.get(G) && r.get(sampleRate) && r.get(z1);
+}
+
 // *---------------------------------------------------------------------------* //
@@ -18,13 +18,122 @@
 #ifndef __XODVAFILTER_BASE_H__
 #define __XODVAFILTER_BASE_H__
 
+// -DXODVA_QUIET removes the coefficient console output of setFc_* /
+// setFcAndRes (library builds - keep it out of audio / host threads)
+
 
 #include <math.h>
+#include <cstdint>
+#include <string.h>
+
+#include "xodVAFilter_state.h"
+
+
 
+constexpr double pi = 3.14159265358979323846;
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Sample Rate Constants ---* //
+
+// filters take their sample rate at initialize - there is no global fs.
+// the prewarp argument pi*fc/fs is formed in double (pi/fs passed as piT), so
+// G stays correctly rounded at low cutoff / high sample rate (up to 384 kHz)
+
+const uint32_t xodNumStdRates = 8;
+const double xodStdRates[xodNumStdRates] = {44100, 48000, 88200, 96000, 176400, 192000, 352800, 384000};
+
+// cutoffs are clamped at coefficient update time - fc >= fs/2 makes the
+// prewarp tan() explode (or wrap), NaN / negative cutoffs map to 0
+const double xodMaxFcNorm = 0.49;	// fc/fs
+
+// prewarp argument x = pi*fc/fs clamped to [0, pi*xodMaxFcNorm]
+inline double xodClampPrewarp(double x) {
+	if (!(x > 0))
+		return 0;
+	return (x < pi*xodMaxFcNorm) ? x : pi*xodMaxFcNorm;
+}
+
+// calculate big G value - Zavalishin p46 (the Art of VA Design)
+// g = wa*T/2 = tan(wd*T/2) reduces to tan(pi*fc/fs) - evaluated in double
+// to avoid the (2/T)*tan()*T/2 round trip through float
+inline float onePoleTPT_calcG(double fc, double piT) {
+	double g = tan(xodClampPrewarp(piT*fc));
+	return (float)(g/(1.0 + g));
+}
+
+// batch form of the above for lane loops - branch free single precision, so a
+// loop over many cutoffs is auto-vectorized (no libm tan call per element)
+// fcNorm = fc/fs, clamped to [0, xodMaxFcNorm]. returns G = g/(1+g), H = 1/(1+g).
+// tan is the Cephes tanf polynomial on [0, pi/4]; above pi/4 the reflection
+// g = 1/tan(pi/2 - x) is folded into G and H, so nothing overflows at Nyquist.
+// within ~3 ulp of onePoleTPT_calcG (44.1k - 384k)
+inline void onePoleTPT_calcGH(float fcNorm, float& G, float& H) {
+	float r = (fcNorm > 0.0f) ? fcNorm : 0.0f;
+	r = (r < (float)xodMaxFcNorm) ? r : (float)xodMaxFcNorm;
+	bool upper = r > 0.25f;
+	float x = (float)pi*(upper ? 0.5f - r : r);
+	float z = x*x;
+	float t = (((((9.38540185543e-3f*z + 3.11992232697e-3f)*z + 2.44301354525e-2f)*z
+				 + 5.34112807005e-2f)*z + 1.33387994085e-1f)*z + 3.33331568548e-1f)*z*x + x;
+	float inv = 1.0f/(1.0f + t);
+	G = upper ? inv : t*inv;
+	H = upper ? t*inv : inv;
+}
+
+// multi-voice filters pack voices into fixed width lanes - lane loops of this
+// width are auto-vectorized by the compiler (8 x float = 1 AVX register)
+const uint32_t xodSimdLanes = 8;
 
 
-const double pi = 3.141595926536;
-const double Fs = 48000;						// Fixed clock frequency
+// *---------------------------------------------------------------------------* //
+// *--- Block-level Blow-up Guard ---* //
+
+// filters check a whole block (output + state) once instead of every sample.
+// max |y| is taken over the IEEE bit patterns: the integer max reduction
+// vectorizes without -ffast-math, and Inf / NaN order above every finite
+// value, so one compare classifies the block
+//		<= limit  : ok
+//		finite    : runaway - soft clamp to +-limit
+//		Inf / NaN : reset the instance, zero the block
+
+const float xodGuardLimit = 1.0e4f;			// default - 80 dB over full scale
+const uint32_t xodInfBits = 0x7f800000;
+
+// guard events of one instance - diagnostics, not part of the saved state
+struct xodGuardStats {
+	uint32_t resets;
+	uint32_t clamps;
+};
+
+inline uint32_t xodAbsBits(float x) {
+	uint32_t b;
+	memcpy(&b, &x, sizeof(b));
+	return b & 0x7fffffff;
+}
+
+inline uint32_t xodMaxAbsBits(const float* y, uint32_t n) {
+	uint32_t m = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t b = xodAbsBits(y[i]);
+		m = (b > m) ? b : m;
+	}
+	return m;
+}
+
+// strided (one channel of an interleaved block)
+inline uint32_t xodMaxAbsBits(const float* y, uint32_t n, uint32_t stride) {
+	uint32_t m = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t b = xodAbsBits(y[i*stride]);
+		m = (b > m) ? b : m;
+	}
+	return m;
+}
+
+inline float xodClampAbs(float x, float limit) {
+	return (x > limit) ? limit : ((x < -limit) ? -limit : x);
+}
 
 // *---------------------------------------------------------------------------* //
 // *--- 1-pole TPT Low-Pass Model ---* //
@@ -46,6 +155,8 @@ public:
 
 	float getSampleRate_LP(){return sampleRate;}
 	float getZ1regValue_LP(){return z1;}
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
 	void setFc_LP(float fc);
 	void doFilterStage_LP(float xn, float& ynLP);
 };
@@ -72,6 +183,8 @@ public:
 
 	float getSampleRate_HP(){return sampleRate;}
 	float getZ1regValue_HP(){return z1;}
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
 	void setFc_HP(float fc);
 	void doFilterStage_HP(float xn, float& ynHP);
 };
@@ -97,6 +210,8 @@ public:
 
 	float getSampleRate_LPHP(){return sampleRate;}
 	float getZ1regValue_LPHP(){return z1;}
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
 	void setFc_LPHP(float fc);
 	void doFilterStage_LPHP(float xn, float& ynLP, float& ynHP);
 };
@@ -122,6 +237,8 @@ public:
 
 	float getSampleRate_AP(){return sampleRate;}
 	float getZ1regValue_AP(){return z1;}
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
 	void setFc_AP(float fc);
 	void doFilterStage_AP(float xn, float& ynAP);
 };
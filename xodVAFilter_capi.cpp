@@ -0,0 +1,464 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_capi.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C ABI for libxodvafilter - thin wrappers over the C++ filters
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <new>
+#include <vector>
+#include <string.h>
+
+#include "xodVAFilter_capi.h"
+#include "xodVAFilter_base.h"
+#include "xodVAFilter.h"
+#include "xodVAFilter_bank.h"
+#include "xodVAFilter_voicePool.h"
+
+
+// *---------------------------------------------------------------------------* //
+// opaque handle bodies - the C side only ever sees pointers to these
+// the ladder / SVF classes don't keep fc, Q or (ladder) fs readable, so the
+// wrappers carry them for reset() and coefficient updates
+
+struct xodvaOnePole {
+	int type;
+	float sampleRate;
+	float fc;
+	onePoleTPT_LP lp;
+	onePoleTPT_HP hp;
+	onePoleTPT_LPHP lphp;
+	onePoleTPT_AP ap;
+};
+
+struct xodvaLadder {
+	float sampleRate;
+	xodMoogLadder4P flt;
+};
+
+struct xodvaLadderMC {
+	xodMoogLadder4P_MC flt;
+};
+
+struct xodvaSVF {
+	float sampleRate;
+	float fc;
+	float Q;
+	xodSVF2P flt;
+};
+
+struct xodvaBank {
+	xodOnePoleBank bank;
+};
+
+struct xodvaVoicePool {
+	xodMoogLadderVoicePool pool;
+};
+
+
+// *---------------------------------------------------------------------------* //
+// nothing may throw across the C boundary - allocation failure (or a bad_alloc
+// out of initialize()) returns NULL
+
+template<class H>
+static H* capiNew() {
+	try {
+		return new H();
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+
+int xodva_abi_version(void) {
+	return XODVA_ABI_VERSION;
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- 1-pole TPT ---* //
+
+static void onePoleInit(xodvaOnePole* h) {
+	switch (h->type) {
+		case XODVA_ONEPOLE_HP: h->hp.initialize_HP(h->sampleRate); h->hp.setFc_HP(h->fc); break;
+		case XODVA_ONEPOLE_LPHP: h->lphp.initialize_LPHP(h->sampleRate); h->lphp.setFc_LPHP(h->fc); break;
+		case XODVA_ONEPOLE_AP: h->ap.initialize_AP(h->sampleRate); h->ap.setFc_AP(h->fc); break;
+		default: h->lp.initialize_LP(h->sampleRate); h->lp.setFc_LP(h->fc); break;
+	}
+}
+
+xodvaOnePole* xodva_onepole_create(int type, float sampleRate) {
+	if (type < XODVA_ONEPOLE_LP || type > XODVA_ONEPOLE_AP || !(sampleRate > 0))
+		return nullptr;
+	xodvaOnePole* h = capiNew<xodvaOnePole>();
+	if (!h)
+		return nullptr;
+	h->type = type;
+	h->sampleRate = sampleRate;
+	h->fc = 0.25f*sampleRate;
+	onePoleInit(h);
+	return h;
+}
+
+void xodva_onepole_destroy(xodvaOnePole* h) {
+	delete h;
+}
+
+void xodva_onepole_reset(xodvaOnePole* h) {
+	onePoleInit(h);
+}
+
+void xodva_onepole_set_fc(xodvaOnePole* h, float fc) {
+	h->fc = fc;
+	switch (h->type) {
+		case XODVA_ONEPOLE_HP: h->hp.setFc_HP(fc); break;
+		case XODVA_ONEPOLE_LPHP: h->lphp.setFc_LPHP(fc); break;
+		case XODVA_ONEPOLE_AP: h->ap.setFc_AP(fc); break;
+		default: h->lp.setFc_LP(fc); break;
+	}
+}
+
+// type switch outside the sample loop
+void xodva_onepole_process(xodvaOnePole* h, const float* in, float* out, uint32_t numSamples) {
+	switch (h->type) {
+		case XODVA_ONEPOLE_HP:
+			for (uint32_t i = 0; i < numSamples; i++)
+				h->hp.doFilterStage_HP(in[i], out[i]);
+			break;
+		case XODVA_ONEPOLE_LPHP:
+			for (uint32_t i = 0; i < numSamples; i++) {
+				float hp;
+				h->lphp.doFilterStage_LPHP(in[i], out[i], hp);
+			}
+			break;
+		case XODVA_ONEPOLE_AP:
+			for (uint32_t i = 0; i < numSamples; i++)
+				h->ap.doFilterStage_AP(in[i], out[i]);
+			break;
+		default:
+			for (uint32_t i = 0; i < numSamples; i++)
+				h->lp.doFilterStage_LP(in[i], out[i]);
+			break;
+	}
+}
+
+void xodva_onepole_process_lphp(xodvaOnePole* h, const float* in, float* outLP, float* outHP, uint32_t numSamples) {
+	if (h->type != XODVA_ONEPOLE_LPHP)
+		return;
+	for (uint32_t i = 0; i < numSamples; i++)
+		h->lphp.doFilterStage_LPHP(in[i], outLP[i], outHP[i]);
+}
+
+void xodva_onepole_set_fc_batch(xodvaOnePole* const* h, const float* fc, uint32_t count) {
+	for (uint32_t i = 0; i < count; i++)
+		xodva_onepole_set_fc(h[i], fc[i]);
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Moog ladder 4-pole ---* //
+
+xodvaLadder* xodva_ladder_create(float sampleRate) {
+	if (!(sampleRate > 0))
+		return nullptr;
+	xodvaLadder* h = capiNew<xodvaLadder>();
+	if (!h)
+		return nullptr;
+	h->sampleRate = sampleRate;
+	h->flt.initialize(sampleRate);
+	h->flt.setFcAndRes(0.25f*sampleRate, 0.0f, sampleRate);
+	return h;
+}
+
+void xodva_ladder_destroy(xodvaLadder* h) {
+	delete h;
+}
+
+void xodva_ladder_reset(xodvaLadder* h) {
+	h->flt.reset();
+}
+
+void xodva_ladder_set_fc_res(xodvaLadder* h, float cutoff, float resonance) {
+	h->flt.setFcAndRes(cutoff, resonance, h->sampleRate);
+}
+
+void xodva_ladder_process(xodvaLadder* h, const float* in, float* out, uint32_t numSamples) {
+	h->flt.advanceBlock(in, out, numSamples);
+}
+
+// vectorized recompute (xodMoogLadderSetFcAndResBatch) over chunks of handles
+static const uint32_t capiBatchChunk = 64;
+
+void xodva_ladder_set_fc_res_batch(xodvaLadder* const* h, const float* cutoff, const float* resonance, uint32_t count) {
+	xodMoogLadder4P* flt[capiBatchChunk];
+	for (uint32_t i0 = 0; i0 < count; i0 += capiBatchChunk) {
+		uint32_t n = (count - i0 < capiBatchChunk) ? count - i0 : capiBatchChunk;
+		for (uint32_t i = 0; i < n; i++)
+			flt[i] = &h[i0 + i]->flt;
+		xodMoogLadderSetFcAndResBatch(flt, &cutoff[i0], &resonance[i0], n);
+	}
+}
+
+void xodva_ladder_set_guard_limit(xodvaLadder* h, float limit) {
+	h->flt.setGuardLimit(limit);
+}
+
+void xodva_ladder_guard_stats(const xodvaLadder* h, uint32_t* resets, uint32_t* clamps) {
+	*resets = h->flt.getGuardStats().resets;
+	*clamps = h->flt.getGuardStats().clamps;
+}
+
+size_t xodva_ladder_save_state(const xodvaLadder* h, uint8_t* buf, size_t capacity) {
+	std::vector<uint8_t> snap;
+	try {
+		xodStateWriter w(snap);
+		h->flt.saveState(w);
+	} catch (...) {
+		return 0;
+	}
+	if (buf && snap.size() <= capacity)
+		memcpy(buf, snap.data(), snap.size());
+	return snap.size();
+}
+
+int xodva_ladder_load_state(xodvaLadder* h, const uint8_t* buf, size_t size) {
+	xodStateReader r(buf, size);
+	if (!h->flt.loadState(r))
+		return 0;
+	// the snapshot carries fs - keep the wrapper in step
+	h->sampleRate = h->flt.getSampleRate();
+	return 1;
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Moog ladder 4-pole multi-channel ---* //
+
+xodvaLadderMC* xodva_ladder_mc_create(uint32_t numChannels, float sampleRate) {
+	if (numChannels == 0 || numChannels > xodSimdLanes || !(sampleRate > 0))
+		return nullptr;
+	xodvaLadderMC* h = capiNew<xodvaLadderMC>();
+	if (!h)
+		return nullptr;
+	h->flt.initialize(numChannels, sampleRate);
+	h->flt.setFcAndRes(0.25f*sampleRate, 0.0f);
+	return h;
+}
+
+void xodva_ladder_mc_destroy(xodvaLadderMC* h) {
+	delete h;
+}
+
+void xodva_ladder_mc_reset(xodvaLadderMC* h) {
+	h->flt.reset();
+}
+
+void xodva_ladder_mc_set_fc_res(xodvaLadderMC* h, float cutoff, float resonance) {
+	h->flt.setFcAndRes(cutoff, resonance);
+}
+
+void xodva_ladder_mc_set_fc_res_channel(xodvaLadderMC* h, uint32_t channel, float cutoff, float resonance) {
+	if (channel < h->flt.getNumChannels())
+		h->flt.setFcAndRes(channel, cutoff, resonance);
+}
+
+void xodva_ladder_mc_set_fc_res_batch(xodvaLadderMC* h, const float* cutoff, const float* resonance) {
+	h->flt.setFcAndResBatch(cutoff, resonance);
+}
+
+void xodva_ladder_mc_set_guard_limit(xodvaLadderMC* h, float limit) {
+	h->flt.setGuardLimit(limit);
+}
+
+void xodva_ladder_mc_guard_stats(const xodvaLadderMC* h, uint32_t* resets, uint32_t* clamps) {
+	*resets = h->flt.getGuardStats().resets;
+	*clamps = h->flt.getGuardStats().clamps;
+}
+
+void xodva_ladder_mc_process_interleaved(xodvaLadderMC* h, float* buf, uint32_t numFrames) {
+	h->flt.processInterleaved(buf, numFrames);
+}
+
+void xodva_ladder_mc_process_planar(xodvaLadderMC* h, float* const* chan, uint32_t numFrames) {
+	h->flt.processPlanar(chan, numFrames);
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- state variable 2-pole ---* //
+
+xodvaSVF* xodva_svf_create(float sampleRate) {
+	if (!(sampleRate > 0))
+		return nullptr;
+	xodvaSVF* h = capiNew<xodvaSVF>();
+	if (!h)
+		return nullptr;
+	h->sampleRate = sampleRate;
+	h->fc = 0.25f*sampleRate;
+	h->Q = 0.7071f;
+	h->flt.initialize_SVF(sampleRate);
+	h->flt.setFcAndQ_SVF(h->fc, h->Q);
+	return h;
+}
+
+void xodva_svf_destroy(xodvaSVF* h) {
+	delete h;
+}
+
+void xodva_svf_reset(xodvaSVF* h) {
+	h->flt.initialize_SVF(h->sampleRate);
+	h->flt.setFcAndQ_SVF(h->fc, h->Q);
+}
+
+void xodva_svf_set_fc_q(xodvaSVF* h, float cutoff, float Q) {
+	h->fc = cutoff;
+	h->Q = Q;
+	h->flt.setFcAndQ_SVF(cutoff, Q);
+}
+
+void xodva_svf_process(xodvaSVF* h, const float* in, float* out, uint32_t numSamples, int type) {
+	if (type < XODVA_SVF_LP || type > XODVA_SVF_PEAK)
+		return;
+	h->flt.processBlock_SVF(in, out, numSamples, (svfType)type);
+}
+
+void xodva_svf_process_all(xodvaSVF* h, const float* in, float* outLP, float* outBP, float* outHP,
+						   float* outNotch, float* outPeak, uint32_t numSamples) {
+	svfBlockOut_t yn = {outLP, outBP, outHP, outNotch, outPeak};
+	h->flt.processBlock_SVF(in, yn, numSamples);
+}
+
+void xodva_svf_set_fc_q_batch(xodvaSVF* const* h, const float* cutoff, const float* Q, uint32_t count) {
+	for (uint32_t i = 0; i < count; i++)
+		xodva_svf_set_fc_q(h[i], cutoff[i], Q[i]);
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- SoA 1-pole filterbank ---* //
+
+xodvaBank* xodva_bank_create(uint32_t numBands, float sampleRate) {
+	if (numBands == 0 || !(sampleRate > 0))
+		return nullptr;
+	xodvaBank* h = capiNew<xodvaBank>();
+	if (!h)
+		return nullptr;
+	if (!h->bank.initialize(numBands, sampleRate)) {
+		delete h;
+		return nullptr;
+	}
+	return h;
+}
+
+void xodva_bank_destroy(xodvaBank* h) {
+	delete h;
+}
+
+void xodva_bank_reset(xodvaBank* h) {
+	h->bank.reset();
+}
+
+uint32_t xodva_bank_stride(const xodvaBank* h) {
+	return h->bank.getStride();
+}
+
+void xodva_bank_set_fc(xodvaBank* h, const float* fc) {
+	h->bank.setFc(fc);
+}
+
+void xodva_bank_set_fc_batch(xodvaBank* h, const float* fc) {
+	h->bank.setFcBatch(fc);
+}
+
+void xodva_bank_process(xodvaBank* h, const float* in, float* out, uint32_t numSamples, int type) {
+	h->bank.processBlock(in, out, numSamples, (type == XODVA_BANK_HP) ? BANK_HP : BANK_LP);
+}
+
+void xodva_bank_process_smooth(xodvaBank* h, const float* in, float* out, uint32_t numSamples, int type) {
+	h->bank.processBlockSmooth(in, out, numSamples, (type == XODVA_BANK_HP) ? BANK_HP : BANK_LP);
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Moog ladder voice pool ---* //
+
+xodvaVoicePool* xodva_pool_create(uint32_t maxVoices, float sampleRate) {
+	if (maxVoices == 0 || !(sampleRate > 0))
+		return nullptr;
+	xodvaVoicePool* h = capiNew<xodvaVoicePool>();
+	if (!h)
+		return nullptr;
+	try {
+		h->pool.initialize(maxVoices, sampleRate);
+	} catch (...) {
+		delete h;
+		return nullptr;
+	}
+	return h;
+}
+
+void xodva_pool_destroy(xodvaVoicePool* h) {
+	delete h;
+}
+
+int32_t xodva_pool_acquire(xodvaVoicePool* h) {
+	return h->pool.acquire();
+}
+
+void xodva_pool_release(xodvaVoicePool* h, int32_t voice) {
+	if (h->pool.isActive(voice))
+		h->pool.release(voice);
+}
+
+uint32_t xodva_pool_num_active(const xodvaVoicePool* h) {
+	return h->pool.getNumActive();
+}
+
+void xodva_pool_set_fc_res(xodvaVoicePool* h, int32_t voice, float cutoff, float resonance) {
+	if (h->pool.isActive(voice))
+		h->pool.voice(voice).setFcAndRes(cutoff, resonance, h->pool.getSampleRate());
+}
+
+void xodva_pool_set_fc_res_batch(xodvaVoicePool* h, const int32_t* voice, const float* cutoff,
+								 const float* resonance, uint32_t count) {
+	xodMoogLadder4P* flt[capiBatchChunk];
+	float fc[capiBatchChunk];
+	float res[capiBatchChunk];
+	uint32_t n = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!h->pool.isActive(voice[i]))
+			continue;
+		flt[n] = &h->pool.voice(voice[i]);
+		fc[n] = cutoff[i];
+		res[n] = resonance[i];
+		if (++n == capiBatchChunk) {
+			xodMoogLadderSetFcAndResBatch(flt, fc, res, n);
+			n = 0;
+		}
+	}
+	if (n)
+		xodMoogLadderSetFcAndResBatch(flt, fc, res, n);
+}
+
+void xodva_pool_set_guard_limit(xodvaVoicePool* h, float limit) {
+	h->pool.setGuardLimit(limit);
+}
+
+void xodva_pool_guard_stats(const xodvaVoicePool* h, uint32_t* resets, uint32_t* clamps) {
+	xodGuardStats gs = h->pool.getGuardStats();
+	*resets = gs.resets;
+	*clamps = gs.clamps;
+}
+
+void xodva_pool_process_mix(xodvaVoicePool* h, const float* const* in, float* out, uint32_t numSamples) {
+	h->pool.processBlockMix(in, out, numSamples);
+}
@@ -0,0 +1,186 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_capi.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C ABI for libxodvafilter
+//			 opaque handles, block / multi-channel processing, batched
+//			 coefficient updates
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	ABI rules:
+//		- plain C types only, no C++ objects or exceptions cross the boundary
+//		- every create returns NULL on failure, destroy accepts NULL
+//		- handles are not thread safe - one handle is driven by one thread
+//		- new functions are only ever appended, XODVA_ABI_VERSION is bumped on
+//		  any incompatible change
+//		- the library is built with XODVA_QUIET (no console output)
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_CAPI_H__
+#define __XODVAFILTER_CAPI_H__
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define XODVA_API __declspec(dllexport)
+#else
+#define XODVA_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define XODVA_ABI_VERSION 1
+
+XODVA_API int xodva_abi_version(void);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- opaque handles ---* //
+
+typedef struct xodvaOnePole xodvaOnePole;		// 1-pole TPT LP / HP / LPHP / AP
+typedef struct xodvaLadder xodvaLadder;			// Moog ladder 4-pole (mono)
+typedef struct xodvaLadderMC xodvaLadderMC;		// Moog ladder 4-pole, up to 8 channels
+typedef struct xodvaSVF xodvaSVF;				// state variable 2-pole
+typedef struct xodvaBank xodvaBank;				// SoA 1-pole filterbank
+typedef struct xodvaVoicePool xodvaVoicePool;	// Moog ladder voice pool
+
+enum {
+	XODVA_ONEPOLE_LP = 0,
+	XODVA_ONEPOLE_HP = 1,
+	XODVA_ONEPOLE_LPHP = 2,
+	XODVA_ONEPOLE_AP = 3
+};
+
+enum {
+	XODVA_SVF_LP = 0,
+	XODVA_SVF_BP = 1,
+	XODVA_SVF_HP = 2,
+	XODVA_SVF_NOTCH = 3,
+	XODVA_SVF_PEAK = 4
+};
+
+enum {
+	XODVA_BANK_LP = 0,
+	XODVA_BANK_HP = 1
+};
+
+
+// *---------------------------------------------------------------------------* //
+// *--- 1-pole TPT ---* //
+
+XODVA_API xodvaOnePole* xodva_onepole_create(int type, float sampleRate);
+XODVA_API void xodva_onepole_destroy(xodvaOnePole* h);
+XODVA_API void xodva_onepole_reset(xodvaOnePole* h);
+XODVA_API void xodva_onepole_set_fc(xodvaOnePole* h, float fc);
+// LPHP handles write the LP output
+XODVA_API void xodva_onepole_process(xodvaOnePole* h, const float* in, float* out, uint32_t numSamples);
+// LPHP handles only
+XODVA_API void xodva_onepole_process_lphp(xodvaOnePole* h, const float* in, float* outLP, float* outHP, uint32_t numSamples);
+XODVA_API void xodva_onepole_set_fc_batch(xodvaOnePole* const* h, const float* fc, uint32_t count);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Moog ladder 4-pole ---* //
+
+XODVA_API xodvaLadder* xodva_ladder_create(float sampleRate);
+XODVA_API void xodva_ladder_destroy(xodvaLadder* h);
+XODVA_API void xodva_ladder_reset(xodvaLadder* h);
+XODVA_API void xodva_ladder_set_fc_res(xodvaLadder* h, float cutoff, float resonance);
+XODVA_API void xodva_ladder_process(xodvaLadder* h, const float* in, float* out, uint32_t numSamples);
+// vectorized single precision recompute - a few ulp from xodva_ladder_set_fc_res
+XODVA_API void xodva_ladder_set_fc_res_batch(xodvaLadder* const* h, const float* cutoff, const float* resonance, uint32_t count);
+
+// block-level blow-up guard - Inf / NaN resets, finite runaways over the
+// limit are clamped; counts since create
+XODVA_API void xodva_ladder_set_guard_limit(xodvaLadder* h, float limit);
+XODVA_API void xodva_ladder_guard_stats(const xodvaLadder* h, uint32_t* resets, uint32_t* clamps);
+
+// snapshot - returns the snapshot size, writes it only if capacity is large enough
+XODVA_API size_t xodva_ladder_save_state(const xodvaLadder* h, uint8_t* buf, size_t capacity);
+XODVA_API int xodva_ladder_load_state(xodvaLadder* h, const uint8_t* buf, size_t size);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Moog ladder 4-pole multi-channel ---* //
+
+XODVA_API xodvaLadderMC* xodva_ladder_mc_create(uint32_t numChannels, float sampleRate);
+XODVA_API void xodva_ladder_mc_destroy(xodvaLadderMC* h);
+XODVA_API void xodva_ladder_mc_reset(xodvaLadderMC* h);
+XODVA_API void xodva_ladder_mc_set_fc_res(xodvaLadderMC* h, float cutoff, float resonance);
+XODVA_API void xodva_ladder_mc_set_fc_res_channel(xodvaLadderMC* h, uint32_t channel, float cutoff, float resonance);
+// cutoff[numChannels], resonance[numChannels] - vectorized, as xodva_ladder_set_fc_res_batch
+XODVA_API void xodva_ladder_mc_set_fc_res_batch(xodvaLadderMC* h, const float* cutoff, const float* resonance);
+XODVA_API void xodva_ladder_mc_set_guard_limit(xodvaLadderMC* h, float limit);
+XODVA_API void xodva_ladder_mc_guard_stats(const xodvaLadderMC* h, uint32_t* resets, uint32_t* clamps);
+// in place
+XODVA_API void xodva_ladder_mc_process_interleaved(xodvaLadderMC* h, float* buf, uint32_t numFrames);
+XODVA_API void xodva_ladder_mc_process_planar(xodvaLadderMC* h, float* const* chan, uint32_t numFrames);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- state variable 2-pole ---* //
+
+XODVA_API xodvaSVF* xodva_svf_create(float sampleRate);
+XODVA_API void xodva_svf_destroy(xodvaSVF* h);
+XODVA_API void xodva_svf_reset(xodvaSVF* h);
+XODVA_API void xodva_svf_set_fc_q(xodvaSVF* h, float cutoff, float Q);
+XODVA_API void xodva_svf_process(xodvaSVF* h, const float* in, float* out, uint32_t numSamples, int type);
+XODVA_API void xodva_svf_process_all(xodvaSVF* h, const float* in, float* outLP, float* outBP, float* outHP,
+									 float* outNotch, float* outPeak, uint32_t numSamples);
+XODVA_API void xodva_svf_set_fc_q_batch(xodvaSVF* const* h, const float* cutoff, const float* Q, uint32_t count);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- SoA 1-pole filterbank ---* //
+
+XODVA_API xodvaBank* xodva_bank_create(uint32_t numBands, float sampleRate);
+XODVA_API void xodva_bank_destroy(xodvaBank* h);
+XODVA_API void xodva_bank_reset(xodvaBank* h);
+XODVA_API uint32_t xodva_bank_stride(const xodvaBank* h);
+XODVA_API void xodva_bank_set_fc(xodvaBank* h, const float* fc);
+// vectorized single precision - for per-block modulation
+XODVA_API void xodva_bank_set_fc_batch(xodvaBank* h, const float* fc);
+// out is sample-major: out[i*stride + band]
+XODVA_API void xodva_bank_process(xodvaBank* h, const float* in, float* out, uint32_t numSamples, int type);
+XODVA_API void xodva_bank_process_smooth(xodvaBank* h, const float* in, float* out, uint32_t numSamples, int type);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Moog ladder voice pool ---* //
+
+XODVA_API xodvaVoicePool* xodva_pool_create(uint32_t maxVoices, float sampleRate);
+XODVA_API void xodva_pool_destroy(xodvaVoicePool* h);
+// returns a voice handle >= 0, or -1 when the pool is full
+XODVA_API int32_t xodva_pool_acquire(xodvaVoicePool* h);
+XODVA_API void xodva_pool_release(xodvaVoicePool* h, int32_t voice);
+XODVA_API uint32_t xodva_pool_num_active(const xodvaVoicePool* h);
+XODVA_API void xodva_pool_set_fc_res(xodvaVoicePool* h, int32_t voice, float cutoff, float resonance);
+// vectorized, as xodva_ladder_set_fc_res_batch
+XODVA_API void xodva_pool_set_fc_res_batch(xodvaVoicePool* h, const int32_t* voice, const float* cutoff,
+										   const float* resonance, uint32_t count);
+XODVA_API void xodva_pool_set_guard_limit(xodvaVoicePool* h, float limit);
+XODVA_API void xodva_pool_guard_stats(const xodvaVoicePool* h, uint32_t* resets, uint32_t* clamps);
+// in[voice] per voice handle - active voices are filtered and summed into out
+XODVA_API void xodva_pool_process_mix(xodvaVoicePool* h, const float* const* in, float* out, uint32_t numSamples);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+
+#endif // __XODVAFILTER_CAPI_H__
@@ -0,0 +1,185 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_crossover.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 single-pass N-band crossover built from 1-pole TPT stages
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <math.h>
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter_crossover.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- N-band Crossover ---* //
+
+const uint32_t xodCrossover::maxBands;
+
+void xodCrossover::initialize(uint32_t newNumBands, xoverType newType, float newSampleRate) {
+
+	numBands = newNumBands;
+	if (numBands < 2)
+		numBands = 2;
+	if (numBands > maxBands)
+		numBands = maxBands;
+
+	type = newType;
+	sampleRate = newSampleRate;
+
+	for (uint32_t k = 0; k < maxBands; k++) {
+		G_HP[k] = 0;
+		G_LP[k] = 0;
+		onHP[k] = (k > 0 && k < numBands) ? 1 : 0;
+		onLP[k] = (k + 1 < numBands) ? 1 : 0;
+		polarity[k] = (type == XOVER_LR2 && (k & 1)) ? -1 : 1;
+	}
+
+	reset();
+
+}
+
+void xodCrossover::reset() {
+	for (uint32_t k = 0; k < maxBands; k++) {
+		z1_HP1[k] = 0;
+		z1_HP2[k] = 0;
+		z1_LP1[k] = 0;
+		z1_LP2[k] = 0;
+	}
+}
+
+void xodCrossover::setSplits(const float* splitFc) {
+
+	double piT = pi/(double)sampleRate;
+
+	for (uint32_t k = 0; k + 1 < numBands; k++) {
+		float G = onePoleTPT_calcG(splitFc[k], piT);
+		G_LP[k] = G;			// high edge of band k
+		G_HP[k + 1] = G;		// low edge of band k+1
+	}
+
+}
+
+void xodCrossover::processBlock(const float* xn, float* const* band, uint32_t numSamples) {
+
+	if (type == XOVER_LR2)
+		processBlock_LR2(xn, band, numSamples);
+	else
+		processBlock_1P(xn, band, numSamples);
+
+}
+
+// complementary 1-pole split - lane k is the LP at split k
+void xodCrossover::processBlock_1P(const float* xn, float* const* band, uint32_t numSamples) {
+
+	alignas(32) float lp[maxBands + 1];
+	const uint32_t last = numBands - 1;
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		float x = xn[i];
+
+		for (uint32_t k = 0; k < maxBands; k++) {
+			float v = (x - z1_LP1[k])*G_LP[k];
+			lp[k + 1] = v + z1_LP1[k];
+			z1_LP1[k] = lp[k + 1] + v;
+		}
+		lp[0] = 0;
+		lp[last + 1] = x;
+
+		for (uint32_t k = 0; k < numBands; k++)
+			band[k][i] = lp[k + 1] - lp[k];
+	}
+
+}
+
+// LR2 matched pairs - lane k is HP2 at split k-1 then LP2 at split k
+void xodCrossover::processBlock_LR2(const float* xn, float* const* band, uint32_t numSamples) {
+
+	alignas(32) float y[maxBands];
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		float x = xn[i];
+
+		for (uint32_t k = 0; k < maxBands; k++) {
+			// HP(HP(x)) - low edge
+			float v = (x - z1_HP1[k])*G_HP[k];
+			float lp = v + z1_HP1[k];
+			z1_HP1[k] = lp + v;
+			float hp1 = x - lp;
+
+			v = (hp1 - z1_HP2[k])*G_HP[k];
+			lp = v + z1_HP2[k];
+			z1_HP2[k] = lp + v;
+			float hp2 = hp1 - lp;
+
+			float u = onHP[k]*hp2 + (1 - onHP[k])*x;
+
+			// LP(LP(u)) - high edge
+			v = (u - z1_LP1[k])*G_LP[k];
+			float lp1 = v + z1_LP1[k];
+			z1_LP1[k] = lp1 + v;
+
+			v = (lp1 - z1_LP2[k])*G_LP[k];
+			float lp2 = v + z1_LP2[k];
+			z1_LP2[k] = lp2 + v;
+
+			y[k] = polarity[k]*(onLP[k]*lp2 + (1 - onLP[k])*u);
+		}
+
+		for (uint32_t k = 0; k < numBands; k++)
+			band[k][i] = y[k];
+	}
+
+}
+
+void xodCrossover::saveState(xodStateWriter& w) const {
+
+	uint32_t t = type;
+	w.put(t);
+	w.put(numBands);
+	w.put(sampleRate);
+	w.putArray(G_HP, maxBands);
+	w.putArray(G_LP, maxBands);
+	w.putArray(z1_HP1, maxBands);
+	w.putArray(z1_HP2, maxBands);
+	w.putArray(z1_LP1, maxBands);
+	w.putArray(z1_LP2, maxBands);
+
+}
+
+bool xodCrossover::loadState(xodStateReader& r) {
+
+	uint32_t t = 0, bands = 0;
+	float fs = 0;
+	if (!r.get(t) || !r.get(bands) || !r.get(fs))
+		return false;
+	if (t > XOVER_LR2 || bands < 2 || bands > maxBands || !(fs > 0))
+		return false;
+
+	// re-derive the band masks in a copy, then restore coefficients and
+	// registers - committed only when the whole snapshot was read
+	xodCrossover x(*this);
+	x.initialize(bands, (xoverType)t, fs);
+	bool ok = r.getArray(x.G_HP, maxBands) && r.getArray(x.G_LP, maxBands)
+		&& r.getArray(x.z1_HP1, maxBands) && r.getArray(x.z1_HP2, maxBands)
+		&& r.getArray(x.z1_LP1, maxBands) && r.getArray(x.z1_LP2, maxBands);
+	if (!ok)
+		return false;
+
+	*this = x;
+	return true;
+}
+
+// *---------------------------------------------------------------------------* //
@@ -0,0 +1,92 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_crossover.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 single-pass N-band crossover built from 1-pole TPT stages
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_CROSSOVER_H__
+#define __XODVAFILTER_CROSSOVER_H__
+
+
+#include <cstdint>
+
+#include "xodVAFilter_base.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- N-band Crossover ---* //
+
+// All split points run in parallel from the input, one lane per band (SoA),
+// so an 8-band split is one vectorized pass that writes every band output.
+//
+//	XOVER_1POLE - complementary 6 dB/oct bands from 1-pole TPT LPs:
+//		band0 = LP0(x), bandk = LPk(x) - LPk-1(x), bandN-1 = x - LPN-2(x)
+//		the bands sum back to x exactly (up to float rounding)
+//	XOVER_LR2 - Linkwitz-Riley style 12 dB/oct matched pairs, each band is
+//		HP(HP(x)) at the lower split then LP(LP(x)) at the upper split. Odd
+//		bands are polarity inverted so a 2-band split sums to an all-pass;
+//		with more bands the parallel band-passes sum with some ripple at the
+//		split points (no all-pass phase compensation)
+
+enum xoverType {
+	XOVER_1POLE = 0,
+	XOVER_LR2
+};
+
+class xodCrossover {
+public:
+
+	static const uint32_t maxBands = xodSimdLanes;
+
+protected:
+	// controls
+	xoverType type;
+	uint32_t numBands;
+	float sampleRate;	// fs
+
+	// lane k: low edge (HP) / high edge (LP) of band k
+	alignas(32) float G_HP[maxBands];
+	alignas(32) float G_LP[maxBands];
+	alignas(32) float onHP[maxBands];		// 0 = band has no low edge (band 0)
+	alignas(32) float onLP[maxBands];		// 0 = band has no high edge (last band)
+	alignas(32) float polarity[maxBands];
+
+	// per lane z-1 registers
+	alignas(32) float z1_HP1[maxBands];
+	alignas(32) float z1_HP2[maxBands];
+	alignas(32) float z1_LP1[maxBands];
+	alignas(32) float z1_LP2[maxBands];
+
+	void processBlock_1P(const float* xn, float* const* band, uint32_t numSamples);
+	void processBlock_LR2(const float* xn, float* const* band, uint32_t numSamples);
+
+public:
+	void initialize(uint32_t newNumBands, xoverType newType, float newSampleRate);
+	void reset();
+
+	uint32_t getNumBands() const {return numBands;}
+
+	// numBands-1 ascending split frequencies
+	void setSplits(const float* splitFc);
+
+	// band[k][i] - all band outputs written in one pass over xn
+	void processBlock(const float* xn, float* const* band, uint32_t numSamples);
+
+	// false on a corrupt snapshot (bad type / band count / sample rate, truncated) - the crossover is untouched
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+
+
+#endif // __XODVAFILTER_CROSSOVER_H__
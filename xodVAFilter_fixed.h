@@ -0,0 +1,130 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_fixed.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 fixed-cutoff 1-pole TPT filters - coefficients computed at compile time
+//			 "The Art Of VA Filter Design" - Vadim Zavalishin
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	cutoff and sample rate are non-type template parameters in Hz, e.g. a
+//	20 Hz DC blocker at 48 kHz:
+//
+//		onePoleTPT_fixed<20, 48000> dcBlock;
+//		dcBlock.doFilterStage_HP(xn, yn);
+//
+//	G is a constexpr - the compiler folds it into the instruction stream, the
+//	filter holds only its z-1 register and needs no setFc / initialize.
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_FIXED_H__
+#define __XODVAFILTER_FIXED_H__
+
+
+#include <cstdint>
+
+#include "xodVAFilter_base.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- constexpr prewarp ---* //
+
+// sin / cos Taylor series - the prewarp argument pi*fc/fs is in [0, pi/2)
+// so no range reduction is needed, 24 terms are exact to double precision
+constexpr double xodConstSin(double x) {
+	double term = x;
+	double sum = x;
+	for (int n = 1; n < 24; n++) {
+		term *= -x*x/((2*n)*(2*n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double xodConstCos(double x) {
+	double term = 1;
+	double sum = 1;
+	for (int n = 1; n < 24; n++) {
+		term *= -x*x/((2*n - 1)*(2*n));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double xodConstTan(double x) {
+	return xodConstSin(x)/xodConstCos(x);
+}
+
+// big G - Zavalishin p46, same as onePoleTPT_calcG() but at compile time
+constexpr float onePoleTPT_constG(double fc, double sampleRate) {
+	return (float)(xodConstTan(pi*fc/sampleRate)/(1.0 + xodConstTan(pi*fc/sampleRate)));
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- 1-pole TPT fixed-cutoff Model (LP, HP, LP+HP, AP) ---* //
+
+template<uint32_t cutoffHz, uint32_t sampleRateHz>
+class onePoleTPT_fixed {
+public:
+
+	static_assert(cutoffHz > 0 && 2*(uint64_t)cutoffHz < sampleRateHz, "onePoleTPT_fixed: cutoff must be in (0, fs/2)");
+
+	static constexpr float G = onePoleTPT_constG(cutoffHz, sampleRateHz);
+	static constexpr float sampleRate = sampleRateHz;
+
+protected:
+	float z1 = 0;		// z-1 register
+
+public:
+	inline void reset() {z1 = 0;}
+	float getZ1regValue(){return z1;}
+
+	inline void doFilterStage_LP(float xn, float& ynLP) {
+		float v = (xn - z1)*G;
+		ynLP = v + z1;
+		z1 = ynLP + v;
+	}
+
+	inline void doFilterStage_HP(float xn, float& ynHP) {
+		float v = (xn - z1)*G;
+		float ynLP = v + z1;
+		ynHP = xn - ynLP;
+		z1 = ynLP + v;
+	}
+
+	inline void doFilterStage_LPHP(float xn, float& ynLP, float& ynHP) {
+		float v = (xn - z1)*G;
+		ynLP = v + z1;
+		ynHP = xn - ynLP;
+		z1 = ynLP + v;
+	}
+
+	inline void doFilterStage_AP(float xn, float& ynAP) {
+		float v = (xn - z1)*G;
+		float LP = v + z1;
+		float HP = xn - LP;
+		ynAP = LP - HP;
+		z1 = LP + v;
+	}
+
+	void saveState(xodStateWriter& w) const {w.put(z1);}
+	bool loadState(xodStateReader& r) {return r.get(z1);}
+};
+
+// 1-pole HP used as a DC blocker
+template<uint32_t sampleRateHz, uint32_t cutoffHz = 10>
+using xodDCBlocker = onePoleTPT_fixed<cutoffHz, sampleRateHz>;
+
+
+
+#endif // __XODVAFILTER_FIXED_H__
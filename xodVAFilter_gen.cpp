@@ -0,0 +1,148 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_gen.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 deterministic test / benchmark signal generators
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <math.h>
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter_gen.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- block generators ---* //
+
+void xodGenNoise(float* buf, uint32_t numSamples, uint64_t seed, uint64_t start, float amplitude) {
+
+	uint32_t i = 0;
+	while (i < numSamples) {
+		// split at 2^32 counter boundaries - the key is fixed within a segment
+		uint64_t n = start + i;
+		uint64_t segEnd = ((n >> 32) + 1) << 32;
+		uint32_t len = (segEnd - n < (uint64_t)(numSamples - i)) ? (uint32_t)(segEnd - n) : numSamples - i;
+
+		uint64_t key = xodHash64(seed ^ xodHash64(n >> 32));
+		uint32_t k0 = (uint32_t)key;
+		uint32_t k1 = (uint32_t)(key >> 32);
+		uint32_t c0 = (uint32_t)n;
+		float* b = buf + i;
+
+		for (uint32_t j = 0; j < len; j++) {
+			uint32_t u = xodHash32(xodHash32(c0 + j + k0) ^ k1);
+			b[j] = amplitude*xodRandBipolar(u);
+		}
+
+		i += len;
+	}
+
+}
+
+// x(t) = sin(2 pi f0 L (e^(t/L) - 1)), L = T / ln(f1/f0)
+void xodGenLogSweep(float* buf, uint32_t numSamples, double f0, double f1, uint64_t sweepSamples,
+					double sampleRate, uint64_t start, float amplitude) {
+
+	double T = (double)sweepSamples/sampleRate;
+	double L = T/log(f1/f0);
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		double t = (double)(start + i)/sampleRate;
+		buf[i] = amplitude*(float)sin(2*pi*f0*L*(exp(t/L) - 1));
+	}
+
+}
+
+// x(t) = sin(2 pi (f0 t + (f1 - f0) t^2 / 2T))
+void xodGenChirp(float* buf, uint32_t numSamples, double f0, double f1, uint64_t chirpSamples,
+				 double sampleRate, uint64_t start, float amplitude) {
+
+	double T = (double)chirpSamples/sampleRate;
+	double k = (f1 - f0)/(2*T);
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		double t = (double)(start + i)/sampleRate;
+		buf[i] = amplitude*(float)sin(2*pi*(f0*t + k*t*t));
+	}
+
+}
+
+void xodGenSquare(float* buf, uint32_t numSamples, double freq, double sampleRate, uint64_t start, float amplitude) {
+
+	double inc = freq/sampleRate;
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		double ph = (double)(start + i)*inc;
+		ph -= floor(ph);
+		buf[i] = (ph < 0.5) ? amplitude : -amplitude;
+	}
+
+}
+
+void xodGenSaw(float* buf, uint32_t numSamples, double freq, double sampleRate, uint64_t start, float amplitude) {
+
+	double inc = freq/sampleRate;
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		double ph = (double)(start + i)*inc;
+		ph -= floor(ph);
+		buf[i] = amplitude*(float)(2*ph - 1);
+	}
+
+}
+
+void xodGenImpulse(float* buf, uint32_t numSamples, uint64_t pos, uint64_t start, float amplitude) {
+	for (uint32_t i = 0; i < numSamples; i++)
+		buf[i] = (start + i == pos) ? amplitude : 0;
+}
+
+void xodGenStep(float* buf, uint32_t numSamples, uint64_t pos, uint64_t start, float amplitude) {
+	for (uint32_t i = 0; i < numSamples; i++)
+		buf[i] = (start + i >= pos) ? amplitude : 0;
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- pink noise ---* //
+
+void xodPinkNoise::initialize(uint64_t newSeed) {
+	seed = newSeed;
+	counter = 0;
+	b0 = b1 = b2 = b3 = b4 = b5 = b6 = 0;
+}
+
+// Paul Kellet's refined pink filter (+/- 0.05 dB above 9.2 Hz at 44.1 kHz)
+void xodPinkNoise::fill(float* buf, uint32_t numSamples, float amplitude) {
+
+	// white noise straight into the output buffer, then filter in place
+	xodGenNoise(buf, numSamples, seed, counter);
+	counter += numSamples;
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		float white = buf[i];
+		b0 = 0.99886f*b0 + white*0.0555179f;
+		b1 = 0.99332f*b1 + white*0.0750759f;
+		b2 = 0.96900f*b2 + white*0.1538520f;
+		b3 = 0.86650f*b3 + white*0.3104856f;
+		b4 = 0.55000f*b4 + white*0.5329522f;
+		b5 = -0.7616f*b5 - white*0.0168980f;
+		float pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white*0.5362f;
+		b6 = white*0.115926f;
+		buf[i] = amplitude*0.11f*pink;		// ~ unity peak
+	}
+
+}
+
+// *---------------------------------------------------------------------------* //
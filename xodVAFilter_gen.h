@@ -0,0 +1,116 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_gen.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 deterministic test / benchmark signal generators
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	every generator fills a block directly. the stateless ones compute sample
+//	i from (seed, start + i) only, so a long signal can be filled in chunks,
+//	by several threads, in any order, with the same result. noise, square,
+//	saw, impulse and step use exact IEEE ops only and are bit identical on
+//	every platform; sweep and chirp go through libm sin / exp and are only
+//	identical within one libm.
+//
+//		noise  - counter-based hash PRNG: sample n = hash(seed, n), uniform
+//				 [-1, 1). 32-bit integer ops only - the fill loop vectorizes
+//		pink   - white noise (as above) through Paul Kellet's 3 dB/oct filter
+//				 (stateful - fill chunks in order)
+//		sweep  - exponential (log) sine sweep, Farina
+//		chirp  - linear frequency sine chirp
+//		square / saw - naive (aliased) waveforms, phase from the sample index
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_GEN_H__
+#define __XODVAFILTER_GEN_H__
+
+
+#include <cstdint>
+
+#include "xodVAFilter_base.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- counter-based PRNG ---* //
+
+// 32-bit integer finalizer (bijective) - "lowbias32", C. Wellons
+inline uint32_t xodHash32(uint32_t x) {
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+// 64-bit finalizer - derives per stream / per 2^32 segment keys
+inline uint64_t xodHash64(uint64_t x) {
+	x += 0x9e3779b97f4a7c15ull;
+	x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27))*0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+
+// uniform 32-bit value n of stream seed
+inline uint32_t xodRandU32(uint64_t seed, uint64_t n) {
+	uint64_t key = xodHash64(seed ^ xodHash64(n >> 32));
+	return xodHash32(xodHash32((uint32_t)n + (uint32_t)key) ^ (uint32_t)(key >> 32));
+}
+
+// [-1, 1) with 24 bit resolution
+inline float xodRandBipolar(uint32_t u) {
+	return (float)(int32_t)(u >> 8)*(2.0f/16777216.0f) - 1.0f;
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- block generators ---* //
+
+// white noise - buf[i] = sample (start + i) of stream seed
+void xodGenNoise(float* buf, uint32_t numSamples, uint64_t seed, uint64_t start = 0, float amplitude = 1);
+
+// exponential sine sweep f0 -> f1 over sweepSamples samples
+void xodGenLogSweep(float* buf, uint32_t numSamples, double f0, double f1, uint64_t sweepSamples,
+					double sampleRate, uint64_t start = 0, float amplitude = 1);
+
+// linear chirp f0 -> f1 over chirpSamples samples
+void xodGenChirp(float* buf, uint32_t numSamples, double f0, double f1, uint64_t chirpSamples,
+				 double sampleRate, uint64_t start = 0, float amplitude = 1);
+
+void xodGenSquare(float* buf, uint32_t numSamples, double freq, double sampleRate, uint64_t start = 0, float amplitude = 1);
+void xodGenSaw(float* buf, uint32_t numSamples, double freq, double sampleRate, uint64_t start = 0, float amplitude = 1);
+
+// impulse at sample pos, step from sample pos on
+void xodGenImpulse(float* buf, uint32_t numSamples, uint64_t pos, uint64_t start = 0, float amplitude = 1);
+void xodGenStep(float* buf, uint32_t numSamples, uint64_t pos, uint64_t start = 0, float amplitude = 1);
+
+
+// *---------------------------------------------------------------------------* //
+// *--- pink noise ---* //
+
+class xodPinkNoise {
+public:
+
+protected:
+	uint64_t seed;
+	uint64_t counter;	// next white noise sample index
+	float b0, b1, b2, b3, b4, b5, b6;
+
+public:
+	void initialize(uint64_t newSeed);
+	void fill(float* buf, uint32_t numSamples, float amplitude = 1);
+};
+
+
+
+#endif // __XODVAFILTER_GEN_H__
@@ -0,0 +1,431 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_graph.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 filter graph executor - fan-out / fan-in patches of the
+//			 existing filters, block buffer reuse, parallel branches
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <vector>
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter.h"
+#include "xodVAFilter_workers.h"
+#include "xodVAFilter_graph.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Filter Graph ---* //
+
+const int32_t xodFilterGraph::noNode;
+
+xodFilterGraph::xodFilterGraph() : numInputs(0), numOutputs(0), compiled(false), numBuffers(0),
+								   maxBlockSize(0), workers(0), callIn(0), callOut(0), callSamples(0), callLevel(0) {
+}
+
+int32_t xodFilterGraph::addNode(graphNodeType type, uint32_t obj, uint32_t numIn, uint32_t numOut) {
+
+	node_t nd;
+	nd.type = type;
+	nd.obj = obj;
+	nd.numOut = numOut;
+	port_t none = {noNode, 0};
+	nd.in.assign(numIn, none);
+	nd.response = SVF_LP;
+	nd.level = 0;
+	nd.outBuf[0] = 0;
+	nd.outBuf[1] = 0;
+
+	nodes.push_back(nd);
+	compiled = false;
+	return (int32_t)nodes.size() - 1;
+
+}
+
+int32_t xodFilterGraph::addInput() {
+	return addNode(GRAPH_INPUT, numInputs++, 0, 1);
+}
+
+int32_t xodFilterGraph::addOutput() {
+	return addNode(GRAPH_OUTPUT, numOutputs++, 1, 0);
+}
+
+int32_t xodFilterGraph::addOnePole(graphNodeType type, float sampleRate, float fc) {
+
+	switch (type) {
+		case GRAPH_LP:
+			lp.push_back(onePoleTPT_LP());
+			lp.back().initialize_LP(sampleRate);
+			lp.back().setFc_LP(fc);
+			return addNode(type, (uint32_t)lp.size() - 1, 1, 1);
+		case GRAPH_HP:
+			hp.push_back(onePoleTPT_HP());
+			hp.back().initialize_HP(sampleRate);
+			hp.back().setFc_HP(fc);
+			return addNode(type, (uint32_t)hp.size() - 1, 1, 1);
+		case GRAPH_LPHP:
+			lphp.push_back(onePoleTPT_LPHP());
+			lphp.back().initialize_LPHP(sampleRate);
+			lphp.back().setFc_LPHP(fc);
+			return addNode(type, (uint32_t)lphp.size() - 1, 1, 2);
+		case GRAPH_AP:
+			ap.push_back(onePoleTPT_AP());
+			ap.back().initialize_AP(sampleRate);
+			ap.back().setFc_AP(fc);
+			return addNode(type, (uint32_t)ap.size() - 1, 1, 1);
+		default:
+			return noNode;
+	}
+
+}
+
+int32_t xodFilterGraph::addLadder(float sampleRate, float fc, float resonance) {
+	ladder.push_back(xodMoogLadder4P());
+	ladder.back().initialize(sampleRate);
+	ladder.back().setFcAndRes(fc, resonance, sampleRate);
+	return addNode(GRAPH_LADDER, (uint32_t)ladder.size() - 1, 1, 1);
+}
+
+int32_t xodFilterGraph::addSVF(float sampleRate, float fc, float Q, svfType response) {
+	svf.push_back(xodSVF2P());
+	svf.back().initialize_SVF(sampleRate);
+	svf.back().setFcAndQ_SVF(fc, Q);
+	int32_t n = addNode(GRAPH_SVF, (uint32_t)svf.size() - 1, 1, 1);
+	nodes[n].response = response;
+	return n;
+}
+
+int32_t xodFilterGraph::addMix(uint32_t numIn, float gain) {
+	if (numIn == 0)
+		return noNode;
+	int32_t n = addNode(GRAPH_MIX, 0, numIn, 1);
+	nodes[n].gain.assign(numIn, gain);
+	return n;
+}
+
+bool xodFilterGraph::connect(int32_t src, uint32_t srcPort, int32_t dst, uint32_t dstPort) {
+
+	if (src < 0 || dst < 0 || (uint32_t)src >= nodes.size() || (uint32_t)dst >= nodes.size())
+		return false;
+	if (srcPort >= nodes[src].numOut || dstPort >= nodes[dst].in.size())
+		return false;
+
+	nodes[dst].in[dstPort].node = src;
+	nodes[dst].in[dstPort].port = srcPort;
+	compiled = false;
+	return true;
+
+}
+
+uint32_t xodFilterGraph::getNumEdges() const {
+	uint32_t e = 0;
+	for (size_t n = 0; n < nodes.size(); n++)
+		for (size_t i = 0; i < nodes[n].in.size(); i++)
+			e += (nodes[n].in[i].node != noNode);
+	return e;
+}
+
+
+// *---------------------------------------------------------------------------* //
+// compile - schedule, liveness, buffer assignment
+
+bool xodFilterGraph::compile(uint32_t newMaxBlockSize, xodRTWorkerPool* newWorkers) {
+
+	compiled = false;
+	maxBlockSize = newMaxBlockSize;
+	workers = newWorkers;
+
+	uint32_t numNodes = (uint32_t)nodes.size();
+
+	// Kahn's algorithm over distinct source nodes, level = longest path from a source
+	std::vector<std::vector<uint32_t>> succ(numNodes);
+	std::vector<uint32_t> indeg(numNodes, 0);
+	for (uint32_t n = 0; n < numNodes; n++) {
+		for (size_t i = 0; i < nodes[n].in.size(); i++) {
+			int32_t s = nodes[n].in[i].node;
+			if (s != noNode) {
+				succ[s].push_back(n);
+				indeg[n]++;
+			}
+		}
+		nodes[n].level = 0;
+	}
+
+	std::vector<uint32_t> ready;
+	for (uint32_t n = 0; n < numNodes; n++)
+		if (indeg[n] == 0)
+			ready.push_back(n);
+
+	uint32_t numSorted = 0;
+	uint32_t numLevels = 0;
+	while (!ready.empty()) {
+		uint32_t n = ready.back();
+		ready.pop_back();
+		numSorted++;
+		if (nodes[n].level + 1 > numLevels)
+			numLevels = nodes[n].level + 1;
+		for (size_t k = 0; k < succ[n].size(); k++) {
+			uint32_t d = succ[n][k];
+			if (nodes[n].level + 1 > nodes[d].level)
+				nodes[d].level = nodes[n].level + 1;
+			if (--indeg[d] == 0)
+				ready.push_back(d);
+		}
+	}
+	if (numSorted != numNodes)
+		return false;
+
+	// single thread - one node per step in depth-first post order from the sinks:
+	// a branch runs to its end before the next one starts, so only the outputs
+	// waiting for a fan-in stay live instead of a whole level's
+	if (!workers) {
+		std::vector<uint8_t> visited(numNodes, 0);
+		std::vector<port_t> stack;		// node, next input to visit
+		uint32_t pos = 0;
+		for (uint32_t r = 0; r < numNodes; r++) {
+			if (!succ[r].empty() || visited[r])
+				continue;
+			visited[r] = 1;
+			port_t root = {(int32_t)r, 0};
+			stack.push_back(root);
+			while (!stack.empty()) {
+				port_t& top = stack.back();
+				const node_t& nd = nodes[top.node];
+				if (top.port < nd.in.size()) {
+					int32_t s = nd.in[top.port++].node;
+					if (s != noNode && !visited[s]) {
+						visited[s] = 1;
+						port_t next = {s, 0};
+						stack.push_back(next);
+					}
+				} else {
+					nodes[top.node].level = pos++;
+					stack.pop_back();
+				}
+			}
+		}
+		numLevels = numNodes;
+	}
+
+	// schedule - stable by level
+	order.clear();
+	levelStart.assign(numLevels + 1, 0);
+	for (uint32_t n = 0; n < numNodes; n++)
+		levelStart[nodes[n].level + 1]++;
+	for (uint32_t l = 0; l < numLevels; l++)
+		levelStart[l + 1] += levelStart[l];
+	order.resize(numNodes);
+	std::vector<uint32_t> fill(levelStart.begin(), levelStart.end() - 1);
+	for (uint32_t n = 0; n < numNodes; n++)
+		order[fill[nodes[n].level]++] = n;
+
+	// liveness - last level that reads each (node, port)
+	std::vector<int32_t> lastUse(2*numNodes, -1);
+	for (uint32_t n = 0; n < numNodes; n++) {
+		for (size_t i = 0; i < nodes[n].in.size(); i++) {
+			const port_t& p = nodes[n].in[i];
+			if (p.node != noNode && (int32_t)nodes[n].level > lastUse[2*p.node + p.port])
+				lastUse[2*p.node + p.port] = nodes[n].level;
+		}
+	}
+
+	// greedy interval colouring in level order. a buffer released by a level
+	// becomes free for the levels after it (parallel nodes of the reading
+	// level may still be writing their own outputs)
+	std::vector<uint32_t> freeBufs;
+	std::vector<std::vector<uint32_t>> releaseAt(numLevels + 1);
+	numBuffers = 0;
+
+	for (uint32_t l = 0; l < numLevels; l++) {
+		for (size_t k = 0; k < releaseAt[l].size(); k++)
+			freeBufs.push_back(releaseAt[l][k]);
+		releaseAt[l].clear();
+
+		for (uint32_t s = levelStart[l]; s < levelStart[l + 1]; s++) {
+			node_t& nd = nodes[order[s]];
+			for (uint32_t p = 0; p < nd.numOut; p++) {
+				if (nd.type == GRAPH_INPUT)
+					continue;
+				uint32_t b;
+				if (!freeBufs.empty()) {
+					b = freeBufs.back();
+					freeBufs.pop_back();
+				} else {
+					b = numBuffers++;
+				}
+				nd.outBuf[p] = b;
+				// unread outputs are released after their own level
+				int32_t last = lastUse[2*order[s] + p];
+				releaseAt[((last < 0) ? l : (uint32_t)last) + 1].push_back(b);
+			}
+		}
+	}
+
+	// graph inputs and unconnected inputs resolve after numBuffers is known
+	uint32_t zeroBuf = numBuffers;
+	for (uint32_t n = 0; n < numNodes; n++) {
+		if (nodes[n].type == GRAPH_INPUT)
+			nodes[n].outBuf[0] = numBuffers + 1 + nodes[n].obj;
+	}
+	for (uint32_t n = 0; n < numNodes; n++) {
+		node_t& nd = nodes[n];
+		nd.inBuf.resize(nd.in.size());
+		for (size_t i = 0; i < nd.in.size(); i++)
+			nd.inBuf[i] = (nd.in[i].node == noNode) ? zeroBuf : nodes[nd.in[i].node].outBuf[nd.in[i].port];
+	}
+
+	bufMem.assign((size_t)(numBuffers + 1)*maxBlockSize, 0.0f);
+
+	compiled = true;
+	return true;
+
+}
+
+
+// *---------------------------------------------------------------------------* //
+// process
+
+void xodFilterGraph::processNode(uint32_t n) {
+
+	node_t& nd = nodes[n];
+	uint32_t ns = callSamples;
+	const float* x = nd.inBuf.empty() ? 0 : bufIn(nd.inBuf[0]);
+	float* y = (nd.numOut && nd.type != GRAPH_INPUT) ? &bufMem[(size_t)nd.outBuf[0]*maxBlockSize] : 0;
+
+	switch (nd.type) {
+		case GRAPH_INPUT:
+			break;
+		case GRAPH_OUTPUT: {
+			float* o = callOut[nd.obj];
+			for (uint32_t i = 0; i < ns; i++)
+				o[i] = x[i];
+			break;
+		}
+		case GRAPH_LP: {
+			onePoleTPT_LP& f = lp[nd.obj];
+			for (uint32_t i = 0; i < ns; i++)
+				f.doFilterStage_LP(x[i], y[i]);
+			break;
+		}
+		case GRAPH_HP: {
+			onePoleTPT_HP& f = hp[nd.obj];
+			for (uint32_t i = 0; i < ns; i++)
+				f.doFilterStage_HP(x[i], y[i]);
+			break;
+		}
+		case GRAPH_LPHP: {
+			onePoleTPT_LPHP& f = lphp[nd.obj];
+			float* yHP = &bufMem[(size_t)nd.outBuf[1]*maxBlockSize];
+			for (uint32_t i = 0; i < ns; i++)
+				f.doFilterStage_LPHP(x[i], y[i], yHP[i]);
+			break;
+		}
+		case GRAPH_AP: {
+			onePoleTPT_AP& f = ap[nd.obj];
+			for (uint32_t i = 0; i < ns; i++)
+				f.doFilterStage_AP(x[i], y[i]);
+			break;
+		}
+		case GRAPH_LADDER:
+			ladder[nd.obj].advanceBlock(x, y, ns);
+			break;
+		case GRAPH_SVF:
+			svf[nd.obj].processBlock_SVF(x, y, ns, nd.response);
+			break;
+		case GRAPH_MIX: {
+			float g = nd.gain[0];
+			for (uint32_t i = 0; i < ns; i++)
+				y[i] = g*x[i];
+			for (size_t k = 1; k < nd.inBuf.size(); k++) {
+				const float* xk = bufIn(nd.inBuf[k]);
+				float gk = nd.gain[k];
+				for (uint32_t i = 0; i < ns; i++)
+					y[i] += gk*xk[i];
+			}
+			break;
+		}
+	}
+
+}
+
+void xodFilterGraph::runNode(void* ctx, uint32_t task) {
+	xodFilterGraph* g = static_cast<xodFilterGraph*>(ctx);
+	g->processNode(g->order[g->levelStart[g->callLevel] + task]);
+}
+
+// level by level - a level with more than one node runs on the worker pool
+void xodFilterGraph::process(const float* const* in, float* const* out, uint32_t numSamples) {
+
+	if (!compiled || numSamples > maxBlockSize)
+		return;
+
+	callIn = in;
+	callOut = out;
+	callSamples = numSamples;
+
+	uint32_t numLevels = (uint32_t)levelStart.size() - 1;
+	for (uint32_t l = 0; l < numLevels; l++) {
+		uint32_t n = levelStart[l + 1] - levelStart[l];
+		if (workers && n > 1) {
+			callLevel = l;
+			workers->run(runNode, this, n);
+		} else {
+			for (uint32_t s = levelStart[l]; s < levelStart[l + 1]; s++)
+				processNode(order[s]);
+		}
+	}
+
+}
+
+
+// *---------------------------------------------------------------------------* //
+// controls
+
+void xodFilterGraph::setFc(int32_t node, float fc) {
+	if (node < 0 || (uint32_t)node >= nodes.size())
+		return;
+	const node_t& nd = nodes[node];
+	switch (nd.type) {
+		case GRAPH_LP: lp[nd.obj].setFc_LP(fc); break;
+		case GRAPH_HP: hp[nd.obj].setFc_HP(fc); break;
+		case GRAPH_LPHP: lphp[nd.obj].setFc_LPHP(fc); break;
+		case GRAPH_AP: ap[nd.obj].setFc_AP(fc); break;
+		default: break;
+	}
+}
+
+void xodFilterGraph::setFcAndRes(int32_t node, float fc, float resonance) {
+	if (node < 0 || (uint32_t)node >= nodes.size())
+		return;
+	const node_t& nd = nodes[node];
+	if (nd.type == GRAPH_LADDER)
+		ladder[nd.obj].setFcAndRes(fc, resonance, ladder[nd.obj].getSampleRate());
+}
+
+void xodFilterGraph::setFcAndQ(int32_t node, float fc, float Q) {
+	if (node < 0 || (uint32_t)node >= nodes.size())
+		return;
+	const node_t& nd = nodes[node];
+	if (nd.type == GRAPH_SVF)
+		svf[nd.obj].setFcAndQ_SVF(fc, Q);
+}
+
+void xodFilterGraph::setGain(int32_t node, uint32_t input, float gain) {
+	if (node < 0 || (uint32_t)node >= nodes.size())
+		return;
+	node_t& nd = nodes[node];
+	if (nd.type == GRAPH_MIX && input < nd.gain.size())
+		nd.gain[input] = gain;
+}
@@ -0,0 +1,185 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_graph.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 filter graph executor - fan-out / fan-in patches of the
+//			 existing filters, block buffer reuse, parallel branches
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	build (setup thread): add nodes, connect output ports to input ports,
+//	compile(). process() then runs one block per call without allocating.
+//
+//		xodFilterGraph g;
+//		int32_t in  = g.addInput();
+//		int32_t xo  = g.addOnePole(GRAPH_LPHP, 48000, 300);		// port 0 LP, 1 HP
+//		int32_t lo  = g.addLadder(48000, 800, 1.2);
+//		int32_t hi  = g.addLadder(48000, 3000, 0.5);
+//		int32_t mix = g.addMix(2);
+//		int32_t out = g.addOutput();
+//		g.connect(in, 0, xo, 0);
+//		g.connect(xo, 0, lo, 0);  g.connect(xo, 1, hi, 0);
+//		g.connect(lo, 0, mix, 0); g.connect(hi, 0, mix, 1);
+//		g.connect(mix, 0, out, 0);
+//		g.compile(256, &workers);
+//
+//	compile()
+//		- schedule: Kahn's topological sort (a cycle fails compile), then
+//		  . with workers - levels: level(node) = 1 + max level of its
+//		    sources. the nodes of one level are independent and run as
+//		    parallel tasks on the worker pool
+//		  . single thread - one node per step, depth-first post order from
+//		    the sinks: each branch runs to its end before the next starts,
+//		    so few buffers are live at once
+//		- liveness: a port buffer is live from its producer's step to the
+//		  last step that reads it. buffers are assigned greedily in step
+//		  order (interval colouring - the minimum for this schedule) and a
+//		  buffer is only reused after its last reader's step has finished,
+//		  so parallel nodes never share one
+//		- unconnected inputs read a shared zero block
+//
+//	the compiled state is indices only - a copied graph owns its buffers and
+//	filter states (and shares the worker pool)
+//
+//	one output port per node except GRAPH_LPHP (LP, HP). GRAPH_MIX sums its
+//	inputs with per-input gains. coefficients may be changed between process()
+//	calls (setFc / setFcAndRes / setFcAndQ / setGain).
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_GRAPH_H__
+#define __XODVAFILTER_GRAPH_H__
+
+
+#include <cstdint>
+#include <vector>
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter.h"
+#include "xodVAFilter_workers.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Filter Graph ---* //
+
+enum graphNodeType {
+	GRAPH_INPUT = 0,		// graph input - external buffer
+	GRAPH_OUTPUT,			// graph output - copied to the external buffer
+	GRAPH_LP,				// onePoleTPT_LP
+	GRAPH_HP,				// onePoleTPT_HP
+	GRAPH_LPHP,				// onePoleTPT_LPHP - 2 outputs
+	GRAPH_AP,				// onePoleTPT_AP
+	GRAPH_LADDER,			// xodMoogLadder4P
+	GRAPH_SVF,				// xodSVF2P - one response
+	GRAPH_MIX				// sum of gain * input
+};
+
+class xodFilterGraph {
+public:
+
+	static const int32_t noNode = -1;
+
+protected:
+
+	struct port_t {
+		int32_t node;
+		uint32_t port;
+	};
+
+	struct node_t {
+		graphNodeType type;
+		uint32_t obj;					// index into the filter vector of its type / graph input, output index
+		uint32_t numOut;
+		std::vector<port_t> in;			// sources (node = noNode: unconnected)
+		std::vector<float> gain;		// GRAPH_MIX
+		svfType response;				// GRAPH_SVF
+
+		// compiled
+		uint32_t level;					// schedule step - level (workers) or depth-first position
+		std::vector<uint32_t> inBuf;	// buffer ids
+		uint32_t outBuf[2];
+	};
+
+	std::vector<node_t> nodes;
+
+	// filter objects by type
+	std::vector<onePoleTPT_LP> lp;
+	std::vector<onePoleTPT_HP> hp;
+	std::vector<onePoleTPT_LPHP> lphp;
+	std::vector<onePoleTPT_AP> ap;
+	std::vector<xodMoogLadder4P> ladder;
+	std::vector<xodSVF2P> svf;
+
+	uint32_t numInputs;
+	uint32_t numOutputs;
+
+	// compiled schedule - nodes sorted by step, levelStart[l] .. levelStart[l+1]
+	bool compiled;
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> levelStart;
+
+	// buffer ids: [0, numBuffers) internal, numBuffers = zero block,
+	// numBuffers + 1 + k = graph input k
+	uint32_t numBuffers;
+	uint32_t maxBlockSize;
+	std::vector<float> bufMem;			// [numBuffers + 1][maxBlockSize]
+	xodRTWorkerPool* workers;
+
+	// current call
+	const float* const* callIn;
+	float* const* callOut;
+	uint32_t callSamples;
+	uint32_t callLevel;
+
+	int32_t addNode(graphNodeType type, uint32_t obj, uint32_t numIn, uint32_t numOut);
+	const float* bufIn(uint32_t b) const {
+		return (b <= numBuffers) ? &bufMem[(size_t)b*maxBlockSize] : callIn[b - numBuffers - 1];
+	}
+	void processNode(uint32_t n);
+	static void runNode(void* ctx, uint32_t task);
+
+public:
+	xodFilterGraph();
+
+	// nodes - return the node id, or noNode
+	int32_t addInput();
+	int32_t addOutput();
+	int32_t addOnePole(graphNodeType type, float sampleRate, float fc);		// GRAPH_LP / HP / LPHP / AP
+	int32_t addLadder(float sampleRate, float fc, float resonance);
+	int32_t addSVF(float sampleRate, float fc, float Q, svfType response);
+	int32_t addMix(uint32_t numIn, float gain = 1.0f);
+
+	bool connect(int32_t src, uint32_t srcPort, int32_t dst, uint32_t dstPort);
+
+	// false on a cycle - workers may be null (single thread)
+	bool compile(uint32_t newMaxBlockSize, xodRTWorkerPool* newWorkers = 0);
+
+	// in[numInputs], out[numOutputs] - numSamples <= maxBlockSize. out must not alias in
+	void process(const float* const* in, float* const* out, uint32_t numSamples);
+
+	// between process() calls - an invalid node is ignored
+	void setFc(int32_t node, float fc);
+	void setFcAndRes(int32_t node, float fc, float resonance);
+	void setFcAndQ(int32_t node, float fc, float Q);
+	void setGain(int32_t node, uint32_t input, float gain);
+
+	uint32_t getNumNodes() const {return (uint32_t)nodes.size();}
+	uint32_t getNumEdges() const;
+	// schedule steps - levels with workers, one per node single thread
+	uint32_t getNumLevels() const {return compiled ? (uint32_t)levelStart.size() - 1 : 0;}
+	uint32_t getNumBuffers() const {return numBuffers;}
+	uint32_t getNumInputs() const {return numInputs;}
+	uint32_t getNumOutputs() const {return numOutputs;}
+};
+
+
+
+#endif // __XODVAFILTER_GRAPH_H__
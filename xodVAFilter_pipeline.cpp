@@ -0,0 +1,304 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_pipeline.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 offline streaming pipeline - overlapped read -> filter -> write
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xodVAFilter_pipeline.h"
+
+
+static inline double nsSince(std::chrono::steady_clock::time_point t0) {
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Block Pipeline ---* //
+
+xodBlockPipeline::xodBlockPipeline()
+{
+	numIn = 0;
+	numOut = 0;
+	blockSize = 0;
+	numSlots = 0;
+	numRead = 0;
+	numFiltered = 0;
+	numWritten = 0;
+	readEnd = false;
+	filterEnd = false;
+	abort = false;
+	stats = xodPipeStats();
+}
+
+void xodBlockPipeline::initialize(uint32_t newNumIn, uint32_t newNumOut, uint32_t newBlockSize, uint32_t newNumSlots)
+{
+	numIn = newNumIn;
+	numOut = newNumOut;
+	blockSize = newBlockSize;
+	numSlots = (newNumSlots < 2) ? 2 : newNumSlots;
+	slotMem.assign((size_t)numSlots*(numIn + numOut)*blockSize, 0.0f);
+	slotSamples.assign(numSlots, 0);
+}
+
+void xodBlockPipeline::readLoop(xodPipeReadFn fn, void* ctx)
+{
+	std::vector<float*> in(numIn + 1);
+
+	for (;;) {
+		uint64_t block;
+		{
+			std::unique_lock<std::mutex> l(lock);
+			if (numRead - numWritten >= numSlots && !abort) {
+				stats.readStalls++;
+				slotFree.wait(l, [this]() {return numRead - numWritten < numSlots || abort;});
+			}
+			if (abort)
+				return;
+			block = numRead;
+		}
+
+		for (uint32_t c = 0; c < numIn; c++)
+			in[c] = slotBuf(block, c);
+		auto t0 = std::chrono::steady_clock::now();
+		uint32_t n = fn(ctx, &in[0], blockSize);
+		stats.nsRead += nsSince(t0);
+
+		std::lock_guard<std::mutex> l(lock);
+		if (n == xodPipeReadError) {
+			stats.readError = true;
+			abort = true;
+			slotRead.notify_one();
+			slotDone.notify_one();
+			return;
+		}
+		if (n == 0) {
+			readEnd = true;
+			slotRead.notify_one();
+			return;
+		}
+		slotSamples[block%numSlots] = (n < blockSize) ? n : blockSize;
+		numRead++;
+		uint32_t inFlight = (uint32_t)(numRead - numWritten);
+		if (inFlight > stats.maxInFlight)
+			stats.maxInFlight = inFlight;
+		slotRead.notify_one();
+	}
+}
+
+void xodBlockPipeline::writeLoop(xodPipeWriteFn fn, void* ctx)
+{
+	std::vector<const float*> in(numIn + 1), out(numOut + 1);
+
+	for (;;) {
+		uint64_t block;
+		{
+			std::unique_lock<std::mutex> l(lock);
+			if (numWritten == numFiltered && !filterEnd && !abort) {
+				stats.writeStalls++;
+				slotDone.wait(l, [this]() {return numWritten < numFiltered || filterEnd || abort;});
+			}
+			if (numWritten == numFiltered || abort)
+				return;
+			block = numWritten;
+		}
+
+		for (uint32_t c = 0; c < numIn; c++)
+			in[c] = slotBuf(block, c);
+		for (uint32_t c = 0; c < numOut; c++)
+			out[c] = slotBuf(block, numIn + c);
+		uint32_t n = slotSamples[block%numSlots];
+		auto t0 = std::chrono::steady_clock::now();
+		bool written = fn(ctx, &in[0], &out[0], n);
+		stats.nsWrite += nsSince(t0);
+
+		std::lock_guard<std::mutex> l(lock);
+		if (!written) {
+			stats.writeError = true;
+			abort = true;
+			slotFree.notify_one();
+			slotRead.notify_one();
+			return;
+		}
+		numWritten++;
+		stats.blocks++;
+		stats.samples += n;
+		slotFree.notify_one();
+	}
+}
+
+bool xodBlockPipeline::run(xodPipeReadFn readFn, void* readCtx, xodPipeFilterFn filterFn, void* filterCtx,
+						   xodPipeWriteFn writeFn, void* writeCtx)
+{
+	if (numSlots == 0 || blockSize == 0)
+		return false;
+
+	numRead = 0;
+	numFiltered = 0;
+	numWritten = 0;
+	readEnd = false;
+	filterEnd = false;
+	abort = false;
+	stats = xodPipeStats();
+
+	auto t0 = std::chrono::steady_clock::now();
+	std::thread reader(&xodBlockPipeline::readLoop, this, readFn, readCtx);
+	std::thread writer(&xodBlockPipeline::writeLoop, this, writeFn, writeCtx);
+
+	// filter - the calling thread
+	std::vector<const float*> in(numIn + 1);
+	std::vector<float*> out(numOut + 1);
+	for (;;) {
+		uint64_t block;
+		{
+			std::unique_lock<std::mutex> l(lock);
+			if (numFiltered == numRead && !readEnd && !abort) {
+				stats.filterStalls++;
+				slotRead.wait(l, [this]() {return numFiltered < numRead || readEnd || abort;});
+			}
+			if (numFiltered == numRead || abort)
+				break;
+			block = numFiltered;
+		}
+
+		for (uint32_t c = 0; c < numIn; c++)
+			in[c] = slotBuf(block, c);
+		for (uint32_t c = 0; c < numOut; c++)
+			out[c] = slotBuf(block, numIn + c);
+		auto tf = std::chrono::steady_clock::now();
+		filterFn(filterCtx, &in[0], &out[0], slotSamples[block%numSlots]);
+		stats.nsFilter += nsSince(tf);
+
+		std::lock_guard<std::mutex> l(lock);
+		numFiltered++;
+		slotDone.notify_one();
+	}
+	{
+		std::lock_guard<std::mutex> l(lock);
+		filterEnd = true;
+		slotDone.notify_one();
+	}
+
+	reader.join();
+	writer.join();
+	stats.nsTotal = nsSince(t0);
+	return !stats.readError && !stats.writeError;
+}
+
+bool xodBlockPipeline::runSerial(xodPipeReadFn readFn, void* readCtx, xodPipeFilterFn filterFn, void* filterCtx,
+								 xodPipeWriteFn writeFn, void* writeCtx)
+{
+	if (numSlots == 0 || blockSize == 0)
+		return false;
+
+	stats = xodPipeStats();
+	stats.maxInFlight = 1;
+
+	std::vector<float*> in(numIn + 1), out(numOut + 1);
+	for (uint32_t c = 0; c < numIn; c++)
+		in[c] = slotBuf(0, c);
+	for (uint32_t c = 0; c < numOut; c++)
+		out[c] = slotBuf(0, numIn + c);
+
+	auto t0 = std::chrono::steady_clock::now();
+	bool ok = true;
+	for (;;) {
+		auto t = std::chrono::steady_clock::now();
+		uint32_t n = readFn(readCtx, &in[0], blockSize);
+		stats.nsRead += nsSince(t);
+		if (n == xodPipeReadError) {
+			stats.readError = true;
+			ok = false;
+			break;
+		}
+		if (n == 0)
+			break;
+		if (n > blockSize)
+			n = blockSize;
+
+		t = std::chrono::steady_clock::now();
+		filterFn(filterCtx, &in[0], &out[0], n);
+		stats.nsFilter += nsSince(t);
+
+		t = std::chrono::steady_clock::now();
+		ok = writeFn(writeCtx, &in[0], &out[0], n);
+		stats.nsWrite += nsSince(t);
+		if (!ok) {
+			stats.writeError = true;
+			break;
+		}
+		stats.blocks++;
+		stats.samples += n;
+	}
+	stats.nsTotal = nsSince(t0);
+	return ok;
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- text .dat stages ---* //
+
+uint32_t xodPipeTextIn::read(void* ctx, float* const* in, uint32_t maxSamples)
+{
+	xodPipeTextIn* t = static_cast<xodPipeTextIn*>(ctx);
+	uint32_t numCh = (uint32_t)t->file.size();
+	uint32_t n = 0;
+	for (; n < maxSamples; n++) {
+		for (uint32_t c = 0; c < numCh; c++) {
+			int got = fscanf(t->file[c], "%f", &in[c][n]);
+			if (got == 1)
+				continue;
+			// a clean end needs every channel at EOF on the first value of a row
+			if (c > 0 || got != EOF || ferror(t->file[c]))
+				return xodPipeReadError;
+			for (uint32_t k = 1; k < numCh; k++) {
+				if (fscanf(t->file[k], " ") == EOF ? ferror(t->file[k]) : fgetc(t->file[k]) != EOF)
+					return xodPipeReadError;
+			}
+			return n;
+		}
+	}
+	return n;
+}
+
+bool xodPipeTextOut::write(void* ctx, const float* const* in, const float* const* out, uint32_t numSamples)
+{
+	xodPipeTextOut* t = static_cast<xodPipeTextOut*>(ctx);
+	for (uint32_t c = 0; c < t->fileIn.size(); c++) {
+		FILE* f = t->fileIn[c];
+		if (!f)
+			continue;
+		for (uint32_t i = 0; i < numSamples; i++)
+			fprintf(f, "%10.7f\n", in[c][i]);
+		if (ferror(f))
+			return false;
+	}
+	for (uint32_t c = 0; c < t->fileOut.size(); c++) {
+		FILE* f = t->fileOut[c];
+		if (!f)
+			continue;
+		for (uint32_t i = 0; i < numSamples; i++)
+			fprintf(f, "%10.7f\n", out[c][i]);
+		if (ferror(f))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,157 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_pipeline.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 offline streaming pipeline - overlapped read -> filter -> write
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	an offline render as three stages on their own threads, connected by one
+//	bounded ring of numSlots block slots (numSlots = 2 double, 3 triple
+//	buffering):
+//
+//		reader thread  : fills slot.in       (waits for a free slot)
+//		caller thread  : slot.in -> slot.out (waits for a read slot)
+//		writer thread  : drains slot.in/out  (waits for a filtered slot)
+//
+//	each slot moves through the stages in order, so the three cursors obey
+//	written <= filtered <= read <= written + numSlots. a stage that runs ahead
+//	blocks (backpressure) - memory stays at numSlots blocks however long the
+//	job, and the throughput approaches that of the slowest stage instead of
+//	the sum of all three. blocks reach the filter and the writer in stream
+//	order, so the output is identical to the sequential render.
+//
+//	stages are plain function pointers + context (no std::function). the
+//	reader returns the samples it produced, 0 at the end of the stream; a
+//	short block is allowed anywhere. a reader returning xodPipeReadError or a
+//	writer returning false aborts the job and run() returns false - a
+//	truncated or unreadable input never passes as a shorter stream.
+//
+//	offline only - the stages block on a mutex / condition variable. compile
+//	with -pthread
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_PIPELINE_H__
+#define __XODVAFILTER_PIPELINE_H__
+
+
+#include <cstdint>
+#include <cstdio>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Block Pipeline ---* //
+
+// in[numIn] - return samples read (<= maxSamples), 0 = end of stream,
+// xodPipeReadError = I/O or format error, the job is aborted
+static const uint32_t xodPipeReadError = 0xffffffffu;
+typedef uint32_t (*xodPipeReadFn)(void* ctx, float* const* in, uint32_t maxSamples);
+// in[numIn] -> out[numOut]
+typedef void (*xodPipeFilterFn)(void* ctx, const float* const* in, float* const* out, uint32_t numSamples);
+// false = I/O error, the job is aborted
+typedef bool (*xodPipeWriteFn)(void* ctx, const float* const* in, const float* const* out, uint32_t numSamples);
+
+struct xodPipeStats {
+	uint64_t samples;		// samples written
+	uint64_t blocks;
+	double nsRead;			// time spent inside each stage callback
+	double nsFilter;
+	double nsWrite;
+	double nsTotal;			// wall clock of run()
+	uint32_t readStalls;	// waits for a free slot (backpressure)
+	uint32_t filterStalls;	// waits for input
+	uint32_t writeStalls;	// waits for filtered blocks
+	uint32_t maxInFlight;	// slots occupied at once - <= numSlots
+	bool readError;			// the reader returned xodPipeReadError
+	bool writeError;		// the writer returned false
+};
+
+class xodBlockPipeline {
+protected:
+	uint32_t numIn;
+	uint32_t numOut;
+	uint32_t blockSize;
+	uint32_t numSlots;
+
+	std::vector<float> slotMem;			// [numSlots][numIn + numOut][blockSize]
+	std::vector<uint32_t> slotSamples;	// samples in slot
+
+	// stream cursors - blocks (not slots) passed by each stage
+	std::mutex lock;
+	std::condition_variable slotFree;	// reader waits
+	std::condition_variable slotRead;	// filter waits
+	std::condition_variable slotDone;	// writer waits
+	uint64_t numRead;
+	uint64_t numFiltered;
+	uint64_t numWritten;
+	bool readEnd;		// reader returned 0
+	bool filterEnd;		// filter passed the last read block
+	bool abort;			// reader or writer failed
+
+	xodPipeStats stats;
+
+	float* slotBuf(uint64_t block, uint32_t ch) {
+		return &slotMem[((block%numSlots)*(numIn + numOut) + ch)*blockSize];
+	}
+
+	void readLoop(xodPipeReadFn fn, void* ctx);
+	void writeLoop(xodPipeWriteFn fn, void* ctx);
+
+public:
+	xodBlockPipeline();
+
+	// numSlots >= 2
+	void initialize(uint32_t newNumIn, uint32_t newNumOut, uint32_t newBlockSize, uint32_t newNumSlots = 3);
+
+	// runs the job to the end - reader and writer on their own threads, the
+	// filter on the calling thread. false if the reader or the writer failed,
+	// or before initialize()
+	bool run(xodPipeReadFn readFn, void* readCtx, xodPipeFilterFn filterFn, void* filterCtx,
+			 xodPipeWriteFn writeFn, void* writeCtx);
+
+	// the same stages one after the other on the calling thread - reference
+	bool runSerial(xodPipeReadFn readFn, void* readCtx, xodPipeFilterFn filterFn, void* filterCtx,
+				   xodPipeWriteFn writeFn, void* writeCtx);
+
+	const xodPipeStats& getStats() const {return stats;}
+	uint32_t getBlockSize() const {return blockSize;}
+	uint32_t getNumSlots() const {return numSlots;}
+};
+
+
+// *---------------------------------------------------------------------------* //
+// *--- text .dat stages ---* //
+
+// the harness data format - one "%10.7f\n" sample per line, a file per channel
+
+// reader: ctx = xodPipeTextIn, in[ch] from file[ch]. end of stream only when
+// every file ends at the same row - a short row, a channel file ending early,
+// a parse or read error is xodPipeReadError
+struct xodPipeTextIn {
+	std::vector<FILE*> file;
+	static uint32_t read(void* ctx, float* const* in, uint32_t maxSamples);
+};
+
+// writer: ctx = xodPipeTextOut, fileIn[ch] <- in[ch], fileOut[ch] <- out[ch]
+// (null = skip the channel)
+struct xodPipeTextOut {
+	std::vector<FILE*> fileIn;
+	std::vector<FILE*> fileOut;
+	static bool write(void* ctx, const float* const* in, const float* const* out, uint32_t numSamples);
+};
+
+
+
+#endif // __XODVAFILTER_PIPELINE_H__
@@ -0,0 +1,225 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_profile.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 per-section cycle profiling (rdtscp) - compile-time enabled
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	enable with -DXODVA_PROFILE, e.g.:
+//	g++ -Wall -O2 -DXODVA_PROFILE -o xodVAFilter xodVAFilter_test.cpp ...
+//
+//	without XODVA_PROFILE every XOD_PROF_* macro expands to nothing and the
+//	filters carry no profiling state.
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_PROFILE_H__
+#define __XODVAFILTER_PROFILE_H__
+
+
+#ifdef XODVA_PROFILE
+
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+
+// *---------------------------------------------------------------------------* //
+// *--- cycle counter ---* //
+
+// rdtscp waits for earlier instructions to retire - counts TSC reference cycles
+inline uint64_t xodReadCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+	unsigned int aux;
+	return __rdtscp(&aux);
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- cycle histogram ---* //
+
+// exact buckets for 0..linearBuckets-1 cycles, log2 buckets above that
+class xodCycleHist {
+public:
+
+	static const uint32_t linearBuckets = 256;
+	static const uint32_t numBuckets = linearBuckets + 32;
+
+protected:
+	uint32_t bucket[numBuckets];
+	uint64_t count;
+	uint64_t total;
+	uint64_t minCycles;
+	uint64_t maxCycles;
+
+	static uint32_t bucketOf(uint64_t c) {
+		if (c < linearBuckets)
+			return (uint32_t)c;
+		uint32_t b = linearBuckets + (63 - __builtin_clzll(c)) - 8;	// log2(256) = 8
+		return (b < numBuckets) ? b : numBuckets - 1;
+	}
+
+	// lower edge of a bucket
+	static uint64_t cyclesOf(uint32_t b) {
+		if (b < linearBuckets)
+			return b;
+		return 1ull << (b - linearBuckets + 8);
+	}
+
+public:
+	xodCycleHist() {reset();}
+
+	void reset() {
+		for (uint32_t b = 0; b < numBuckets; b++)
+			bucket[b] = 0;
+		count = 0;
+		total = 0;
+		minCycles = ~0ull;
+		maxCycles = 0;
+	}
+
+	inline void add(uint64_t c) {
+		bucket[bucketOf(c)]++;
+		count++;
+		total += c;
+		if (c < minCycles) minCycles = c;
+		if (c > maxCycles) maxCycles = c;
+	}
+
+	void merge(const xodCycleHist& h) {
+		for (uint32_t b = 0; b < numBuckets; b++)
+			bucket[b] += h.bucket[b];
+		count += h.count;
+		total += h.total;
+		if (h.minCycles < minCycles) minCycles = h.minCycles;
+		if (h.maxCycles > maxCycles) maxCycles = h.maxCycles;
+	}
+
+	uint64_t getCount() const {return count;}
+	double getMean() const {return count ? (double)total/count : 0;}
+	uint64_t getMin() const {return count ? minCycles : 0;}
+	uint64_t getMax() const {return maxCycles;}
+
+	// p in [0, 100] - exact below linearBuckets, bucket lower edge above
+	uint64_t percentile(double p) const {
+		if (count == 0)
+			return 0;
+		uint64_t rank = (uint64_t)(p/100.0*(count - 1)) + 1;
+		uint64_t acc = 0;
+		for (uint32_t b = 0; b < numBuckets; b++) {
+			acc += bucket[b];
+			if (acc >= rank)
+				return cyclesOf(b);
+		}
+		return maxCycles;
+	}
+};
+
+
+// *---------------------------------------------------------------------------* //
+// *--- section profile ---* //
+
+enum xodProfSection {
+	PROF_ML4P_SM = 0,		// ladder feedback sum of the 4 z-1 states
+	PROF_ML4P_ALPHA0,		// ladder input scaling: fAlpha0*(xn - K*SM)
+	PROF_ML4P_STAGES,		// ladder 4 x onePoleTPTFB_LP::doFilterStage_LP
+	PROF_NUM_SECTIONS
+};
+
+const char* const xodProfSectionName[PROF_NUM_SECTIONS] = {
+	"ML4P SM feedback sum",
+	"ML4P fAlpha0 scaling",
+	"ML4P 4 x TPT stages"
+};
+
+// cost of an empty start/stop pair - subtracted from every sample. measured
+// once - the magic static makes the first call thread safe (worker pool)
+inline uint64_t xodProfOverhead() {
+	static const uint64_t overhead = []() {
+		uint64_t best = ~0ull;
+		for (int i = 0; i < 1000; i++) {
+			uint64_t t0 = xodReadCycles();
+			uint64_t t1 = xodReadCycles();
+			if (t1 - t0 < best) best = t1 - t0;
+		}
+		return best;
+	}();
+	return overhead;
+}
+
+// one histogram per section - held per instance or shared by a bank
+class xodCycleProfile {
+public:
+
+	xodCycleHist sec[PROF_NUM_SECTIONS];
+
+	inline void record(xodProfSection s, uint64_t t0) {
+		uint64_t c = xodReadCycles() - t0;
+		uint64_t o = xodProfOverhead();
+		sec[s].add(c > o ? c - o : 0);
+	}
+
+	void reset() {
+		for (int s = 0; s < PROF_NUM_SECTIONS; s++)
+			sec[s].reset();
+	}
+
+	void merge(const xodCycleProfile& p) {
+		for (int s = 0; s < PROF_NUM_SECTIONS; s++)
+			sec[s].merge(p.sec[s]);
+	}
+
+	void dump(std::ostream& os, const char* name) const {
+		char line[256];
+		os<<std::endl<<"__(( cycle profile: "<<name<<" ))__  (TSC cycles, timer overhead "
+		  <<xodProfOverhead()<<" removed)"<<std::endl;
+		snprintf(line, sizeof(line), "  %-22s %10s %8s %6s %6s %6s %6s %8s %8s\n",
+				 "section", "count", "mean", "min", "p50", "p90", "p99", "p99.9", "max");
+		os<<line;
+		for (int s = 0; s < PROF_NUM_SECTIONS; s++) {
+			const xodCycleHist& h = sec[s];
+			if (h.getCount() == 0)
+				continue;
+			snprintf(line, sizeof(line), "  %-22s %10llu %8.2f %6llu %6llu %6llu %6llu %8llu %8llu\n",
+					 xodProfSectionName[s], (unsigned long long)h.getCount(), h.getMean(),
+					 (unsigned long long)h.getMin(), (unsigned long long)h.percentile(50),
+					 (unsigned long long)h.percentile(90), (unsigned long long)h.percentile(99),
+					 (unsigned long long)h.percentile(99.9), (unsigned long long)h.getMax());
+			os<<line;
+		}
+	}
+};
+
+
+#define XOD_PROF_START(t)				uint64_t t = xodReadCycles()
+#define XOD_PROF_STOP(prof, s, t)		do { if (prof) (prof)->record(s, t); } while (0)
+
+#else	// XODVA_PROFILE
+
+#define XOD_PROF_START(t)
+#define XOD_PROF_STOP(prof, s, t)
+
+#endif	// XODVA_PROFILE
+
+
+
+#endif // __XODVAFILTER_PROFILE_H__
@@ -0,0 +1,253 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_state.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 filter state snapshot / restore + periodic render checkpoints
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	every filter implements:
+//		void saveState(xodStateWriter& w) const;
+//		bool loadState(xodStateReader& r);
+//
+//	a snapshot is the raw bits of the filter registers + coefficients written
+//	in a fixed field order (no padding, no pointers) - identical filter state
+//	always gives identical bytes, so snapshots are safe for replay / diffing.
+//	byte order is the host order (little-endian on x86 / ARM).
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_STATE_H__
+#define __XODVAFILTER_STATE_H__
+
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+// *---------------------------------------------------------------------------* //
+// *--- state writer / reader ---* //
+
+class xodStateWriter {
+public:
+
+protected:
+	std::vector<uint8_t>& buf;
+
+public:
+	explicit xodStateWriter(std::vector<uint8_t>& out) : buf(out) {}
+
+	template<typename T>
+	inline void put(const T& v) {
+		size_t n = buf.size();
+		buf.resize(n + sizeof(T));
+		memcpy(&buf[n], &v, sizeof(T));
+	}
+
+	template<typename T>
+	inline void putArray(const T* v, uint32_t count) {
+		size_t n = buf.size();
+		buf.resize(n + sizeof(T)*count);
+		if (count)
+			memcpy(&buf[n], v, sizeof(T)*count);
+	}
+};
+
+
+class xodStateReader {
+public:
+
+protected:
+	const uint8_t* buf;
+	size_t size;
+	size_t pos;
+	bool ok;
+
+public:
+	xodStateReader(const uint8_t* in, size_t inSize) : buf(in), size(inSize), pos(0), ok(true) {}
+	explicit xodStateReader(const std::vector<uint8_t>& in) : buf(in.data()), size(in.size()), pos(0), ok(true) {}
+
+	// false once any read ran past the end - the target is left partially loaded
+	bool good() const {return ok;}
+	size_t getPos() const {return pos;}
+	size_t getRemaining() const {return ok ? size - pos : 0;}
+
+	template<typename T>
+	inline bool get(T& v) {
+		if (!ok || pos + sizeof(T) > size)
+			return ok = false;
+		memcpy(&v, buf + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	template<typename T>
+	inline bool getArray(T* v, uint32_t count) {
+		if (!ok || pos + sizeof(T)*count > size)
+			return ok = false;
+		if (count)
+			memcpy(v, buf + pos, sizeof(T)*count);
+		pos += sizeof(T)*count;
+		return true;
+	}
+};
+
+
+// *---------------------------------------------------------------------------* //
+// *--- render checkpoints ---* //
+
+// snapshot of a filter (or bank) every 'interval' samples of a render.
+// resume / seek: restore() loads the nearest checkpoint at or before the
+// target sample and returns its position - only the remainder is re-run.
+//
+//		ckpt.initialize(4096);
+//		for (pos = 0; pos < n; pos += blk) {
+//			ckpt.update(flt, pos);			// records when pos hits a multiple of 4096
+//			flt.advanceBlock(&xn[pos], &yn[pos], blk);
+//		}
+//		uint64_t from = ckpt.restore(flt, seekPos);
+//		flt.advanceBlock(&xn[from], &yn[from], seekPos - from);
+//
+// block sizes should divide the interval, otherwise a checkpoint is taken at
+// the first block boundary past each multiple.
+
+template<class F>
+class xodCheckpointer {
+public:
+
+protected:
+	uint64_t interval;
+	uint64_t nextPos;
+	std::vector<uint64_t> position;
+	std::vector<std::vector<uint8_t> > snapshot;
+
+public:
+	void initialize(uint64_t intervalSamples) {
+		interval = intervalSamples ? intervalSamples : 1;
+		clear();
+	}
+
+	void clear() {
+		nextPos = 0;
+		position.clear();
+		snapshot.clear();
+	}
+
+	uint64_t getInterval() const {return interval;}
+	uint32_t getNumCheckpoints() const {return (uint32_t)position.size();}
+	uint64_t getPosition(uint32_t i) const {return position[i];}
+	const std::vector<uint8_t>& getSnapshot(uint32_t i) const {return snapshot[i];}
+
+	// call with the state at samplePos (before processing sample samplePos)
+	void update(const F& flt, uint64_t samplePos) {
+		if (samplePos < nextPos)
+			return;
+
+		// a seek back re-renders - drop checkpoints at or beyond this point
+		while (!position.empty() && position.back() >= samplePos) {
+			position.pop_back();
+			snapshot.pop_back();
+		}
+
+		position.push_back(samplePos);
+		snapshot.push_back(std::vector<uint8_t>());
+		xodStateWriter w(snapshot.back());
+		flt.saveState(w);
+
+		nextPos = (samplePos/interval + 1)*interval;
+	}
+
+	// returns the restored sample position, or ~0 when there is no checkpoint
+	uint64_t restore(F& flt, uint64_t samplePos) {
+		int64_t best = -1;
+		for (uint32_t i = 0; i < position.size(); i++) {
+			if (position[i] <= samplePos)
+				best = i;
+		}
+		if (best < 0)
+			return ~0ull;
+
+		xodStateReader r(snapshot[best]);
+		if (!flt.loadState(r))
+			return ~0ull;
+
+		nextPos = (position[best]/interval + 1)*interval;
+		return position[best];
+	}
+
+	// persist all checkpoints - an interrupted render resumes from the file
+	bool writeFile(const char* path) const {
+		FILE* f = fopen(path, "wb");
+		if (!f)
+			return false;
+		uint32_t numCkpt = (uint32_t)position.size();
+		bool ok = fwrite("XODCKPT1", 1, 8, f) == 8;
+		ok = ok && fwrite(&interval, sizeof(interval), 1, f) == 1;
+		ok = ok && fwrite(&numCkpt, sizeof(numCkpt), 1, f) == 1;
+		for (uint32_t i = 0; ok && i < numCkpt; i++) {
+			uint32_t len = (uint32_t)snapshot[i].size();
+			ok = fwrite(&position[i], sizeof(uint64_t), 1, f) == 1;
+			ok = ok && fwrite(&len, sizeof(len), 1, f) == 1;
+			ok = ok && (len == 0 || fwrite(snapshot[i].data(), 1, len, f) == len);
+		}
+		fclose(f);
+		return ok;
+	}
+
+	// all or nothing - a truncated or corrupt file leaves the checkpoints as
+	// they were. snapshot lengths are checked against the bytes left in the file
+	bool readFile(const char* path) {
+		FILE* f = fopen(path, "rb");
+		if (!f)
+			return false;
+		long fileSize = -1;
+		if (fseek(f, 0, SEEK_END) == 0)
+			fileSize = ftell(f);
+		bool ok = fileSize >= 0 && fseek(f, 0, SEEK_SET) == 0;
+
+		char magic[8];
+		uint64_t fileInterval = 0;
+		uint32_t numCkpt = 0;
+		ok = ok && fread(magic, 1, 8, f) == 8 && memcmp(magic, "XODCKPT1", 8) == 0;
+		ok = ok && fread(&fileInterval, sizeof(fileInterval), 1, f) == 1 && fileInterval > 0;
+		ok = ok && fread(&numCkpt, sizeof(numCkpt), 1, f) == 1;
+
+		std::vector<uint64_t> pos;
+		std::vector<std::vector<uint8_t> > snap;
+		for (uint32_t i = 0; ok && i < numCkpt; i++) {
+			uint64_t p;
+			uint32_t len;
+			ok = fread(&p, sizeof(p), 1, f) == 1 && fread(&len, sizeof(len), 1, f) == 1;
+			long here = ok ? ftell(f) : -1;
+			ok = ok && here >= 0 && (uint64_t)len <= (uint64_t)(fileSize - here);
+			if (!ok)
+				break;
+			pos.push_back(p);
+			snap.push_back(std::vector<uint8_t>(len));
+			ok = (len == 0 || fread(snap.back().data(), 1, len, f) == len);
+		}
+		fclose(f);
+		if (!ok)
+			return false;
+
+		interval = fileInterval;
+		position.swap(pos);
+		snapshot.swap(snap);
+		nextPos = position.empty() ? 0 : (position.back()/interval + 1)*interval;
+		return true;
+	}
+};
+
+
+
+#endif // __XODVAFILTER_STATE_H__
@@ -16,9 +16,16 @@
 // *===========================================================================* //
 //
 //	compiling (GCC): 
-//	g++ -Wall -o xodVAFilter xodVAFilter_test.cpp xodVAFilter_base.cpp xodVAFilter.cpp
+//	g++ -Wall -pthread -o xodVAFilter xodVAFilter_test.cpp xodVAFilter_base.cpp xodVAFilter.cpp xodVAFilter_voicePool.cpp xodVAFilter_allpass.cpp xodVAFilter_crossover.cpp xodVAFilter_bank.cpp xodVAFilter_workers.cpp xodVAFilter_gen.cpp xodVAFilter_capi.cpp xodVAFilter_tune.cpp xodVAFilter_graph.cpp xodVAFilter_pipeline.cpp
 //
+//	multi-voice / multi-channel lane loops (SVF_MV, ML4P_MC) are vectorized at -O3:
+//	g++ -Wall -O3 -march=native -pthread -o xodVAFilter xodVAFilter_test.cpp xodVAFilter_base.cpp xodVAFilter.cpp xodVAFilter_voicePool.cpp xodVAFilter_allpass.cpp xodVAFilter_crossover.cpp xodVAFilter_bank.cpp xodVAFilter_workers.cpp xodVAFilter_gen.cpp xodVAFilter_capi.cpp xodVAFilter_tune.cpp xodVAFilter_graph.cpp xodVAFilter_pipeline.cpp
 //
+//	per-section cycle profiling of the ladder (ML4P, ML4PPOOL, SRBENCH dump histograms):
+//	g++ -Wall -O2 -DXODVA_PROFILE -pthread -o xodVAFilter xodVAFilter_test.cpp xodVAFilter_base.cpp xodVAFilter.cpp xodVAFilter_voicePool.cpp xodVAFilter_allpass.cpp xodVAFilter_crossover.cpp xodVAFilter_bank.cpp xodVAFilter_workers.cpp xodVAFilter_gen.cpp xodVAFilter_capi.cpp xodVAFilter_tune.cpp xodVAFilter_graph.cpp xodVAFilter_pipeline.cpp
+//
+//	or with the Makefile - harness + libxodvafilter.a / libxodvafilter.so (C ABI, xodVAFilter_capi.h):
+//	make && make check
 //
 //
 // *===========================================================================* //
@@ -26,11 +33,27 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstring>
 #include <vector>
 #include <cstdint>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <atomic>
 
 #include "xodVAFilter_base.h"
 #include "xodVAFilter.h"
+#include "xodVAFilter_voicePool.h"
+#include "xodVAFilter_fixed.h"
+#include "xodVAFilter_allpass.h"
+#include "xodVAFilter_crossover.h"
+#include "xodVAFilter_bank.h"
+#include "xodVAFilter_workers.h"
+#include "xodVAFilter_gen.h"
+#include "xodVAFilter_capi.h"
+#include "xodVAFilter_tune.h"
+#include "xodVAFilter_graph.h"
+#include "xodVAFilter_pipeline.h"
 
 using namespace std;
 
@@ -39,7 +62,7 @@ using namespace std;
 // *---------------------------------------------------------------------------* //
 // *--- user settings ---* //
 
-// SOURCE_TYPE: 1 = impulse, 2 = step, 3 = rand
+// SOURCE_TYPE: 1 = impulse, 2 = step, 3 = rand, 4 = log sweep, 5 = chirp, 6 = square, 7 = saw, 8 = pink
 //const int SOURCE_TYPE = 3;
 
 //double noise = .001;    // amount of noise [0 <-> 1] - needs more characterization
@@ -60,16 +83,18 @@ struct UserParam {
 	string    dataPath;			// path to data directory ; (default ./data)
 	string    type;				// filter type: 'LP', 'HP', 'LPHP', 'AP' ;  (default LP)
 	uint32_t  numSamples;		// signal test length: n - number of samples of test ; (default 200)
-	uint16_t  sampleRate;		// filter sample rate: n ; (default 48000)
+	uint32_t  sampleRate;		// filter sample rate: n ; (default 48000, up to 384000)
 	float  cutoff;				// filter cutoff frequency: n ; (default 777)
 	float  resonance;		    // filter resonance: n ; (default 1.0)
-	uint16_t  srcType;			// SOURCE_TYPE: 1 = impulse, 2 = step, 3 = rand ; (default rand)
+	uint16_t  srcType;			// SOURCE_TYPE: 1 = impulse, 2 = step, 3 = rand, 4 = log sweep, 5 = chirp, 6 = square, 7 = saw, 8 = pink ; (default rand)
+	uint64_t  seed;				// noise seed: n ; (default 1)
 };
 
 
 // *---------------------------------------------------------------------------* //
 ///// Calculate prewarp & 'big G' (Zavalishin p46) /////////////////////
 
+// legacy float coefficient path - kept as the reference for 'SRBENCH'
 float onePoleTPT_G(float sampleRate, float cutoff) {
 
 	float G = 0;
@@ -86,6 +111,210 @@ float onePoleTPT_G(float sampleRate, float cutoff) {
 }
 
 
+// *---------------------------------------------------------------------------* //
+///// Sample rate benchmark helpers /////////////////////
+
+// gain (dB) at freq of a 1-pole TPT LP with coefficient G - exact, in double.
+// the bilinear LP g/(g + j*tan(w/2)) with g = G/(1 - G), so the error shows the
+// coefficient alone (a float render adds its own state rounding on top)
+double onePoleLP_gain_dB(float G, double freq, double sampleRate) {
+	double g = (double)G/(1.0 - (double)G);
+	double t = tan(pi*freq/sampleRate);
+	return 10*log10(g*g/(g*g + t*t));
+}
+
+// error of G in float ulp vs G = g/(1+g), g = tan(pi*fc/fs) in long double
+double onePoleTPT_G_ulp(float G, double fc, double sampleRate) {
+	long double t = tanl(3.141592653589793238462643383279503L*(long double)fc/(long double)sampleRate);
+	long double Gx = t/(1 + t);
+	float Gr = (float)Gx;
+	double ulp = nextafterf(Gr, 1.0f) - Gr;
+	return (double)fabsl((long double)G - Gx)/ulp;
+}
+
+// p-th percentile of a set of timings (sorts in place) - 0 for no timings
+double percentile(vector<double>& t, double p) {
+	if (t.empty())
+		return 0;
+	sort(t.begin(), t.end());
+	size_t k = (size_t)(p/100.0*(t.size() - 1));
+	return t[k];
+}
+
+// ns per sample of a filter run over a block of numSamples
+template<typename F>
+double nsPerSample(F run, uint32_t numSamples) {
+	auto t0 = chrono::steady_clock::now();
+	run();
+	auto t1 = chrono::steady_clock::now();
+	return chrono::duration<double, nano>(t1 - t0).count()/numSamples;
+}
+
+// pipeline stages - noise source, ladder, and a writer that fails after maxBlocks
+struct pipeNoise_t {
+	uint64_t seed;
+	uint64_t pos;
+	uint64_t len;
+	static uint32_t read(void* ctx, float* const* in, uint32_t maxSamples) {
+		pipeNoise_t* g = static_cast<pipeNoise_t*>(ctx);
+		uint32_t n = (uint32_t)min<uint64_t>(maxSamples, g->len - g->pos);
+		xodGenNoise(in[0], n, g->seed, g->pos);
+		g->pos += n;
+		return n;
+	}
+};
+
+static void pipeLadder(void* ctx, const float* const* in, float* const* out, uint32_t numSamples) {
+	static_cast<xodMoogLadder4P*>(ctx)->advanceBlock(in[0], out[0], numSamples);
+}
+
+struct pipeFailWriter_t {
+	uint32_t blocks;
+	uint32_t maxBlocks;
+	uint32_t sleepUs;
+	static bool write(void* ctx, const float* const*, const float* const*, uint32_t) {
+		pipeFailWriter_t* w = static_cast<pipeFailWriter_t*>(ctx);
+		if (w->sleepUs)
+			this_thread::sleep_for(chrono::microseconds(w->sleepUs));
+		return ++w->blocks <= w->maxBlocks;
+	}
+};
+
+// .dat output of the offline modes - through the block pipeline: the calling
+// thread filters block k while the writer thread formats block k - 1.
+// filter(x, y, n) renders the next block of xn into the output channels
+const uint32_t datBlockSize = 4096;
+
+struct datSource_t {
+	const float* x;
+	uint32_t len;
+	uint32_t pos;
+	static uint32_t read(void* ctx, float* const* in, uint32_t maxSamples) {
+		datSource_t* d = static_cast<datSource_t*>(ctx);
+		uint32_t n = min(maxSamples, d->len - d->pos);
+		memcpy(in[0], d->x + d->pos, n*sizeof(float));
+		d->pos += n;
+		return n;
+	}
+};
+
+template<typename F>
+static void datFilter(void* ctx, const float* const* in, float* const* out, uint32_t numSamples) {
+	(*static_cast<F*>(ctx))(in[0], out, numSamples);
+}
+
+// one row per sample: value fmt per channel, sep between values (harness
+// multi-column files)
+struct datRowsOut_t {
+	FILE* fIn;
+	FILE* fRows;
+	uint32_t numOut;
+	const char* fmt;
+	const char* sep;
+	static bool write(void* ctx, const float* const* in, const float* const* out, uint32_t numSamples) {
+		datRowsOut_t* w = static_cast<datRowsOut_t*>(ctx);
+		for (uint32_t i = 0; i < numSamples; i++) {
+			fprintf(w->fIn, "%10.7f\n", in[0][i]);
+			for (uint32_t c = 0; c < w->numOut; c++) {
+				fprintf(w->fRows, w->fmt, out[c][i]);
+				fputs((c + 1 < w->numOut) ? w->sep : "\n", w->fRows);
+			}
+		}
+		return !ferror(w->fIn) && !ferror(w->fRows);
+	}
+};
+
+template<typename F>
+static bool pipeDat(const float* xn, uint32_t numSamples, uint32_t numOut, F& filter,
+					xodPipeWriteFn writeFn, void* writeCtx) {
+	datSource_t src = {xn, numSamples, 0};
+	xodBlockPipeline pipe;
+	pipe.initialize(1, numOut, datBlockSize, 3);
+	return pipe.run(datSource_t::read, &src, datFilter<F>, &filter, writeFn, writeCtx);
+}
+
+static bool closeDat(vector<FILE*>& f, const vector<string>& path, bool ok) {
+	for (size_t k = 0; k < f.size(); k++) {
+		if (!f[k]) {
+			cout<<"cannot open "<<path[k]<<endl;
+			ok = false;
+		} else if (fclose(f[k]) != 0) {
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+// inPath <- xn, outPath[c] <- output channel c, one "%10.7f" value per line
+template<typename F>
+static bool writeDat(const float* xn, uint32_t numSamples, const string& inPath,
+					 const vector<string>& outPath, F filter) {
+	vector<string> path(1, inPath);
+	path.insert(path.end(), outPath.begin(), outPath.end());
+	vector<FILE*> f;
+	bool opened = true;
+	for (size_t k = 0; k < path.size(); k++) {
+		f.push_back(fopen(path[k].c_str(), "w"));
+		opened = opened && f.back();
+	}
+	bool ok = false;
+	if (opened) {
+		xodPipeTextOut wr;
+		wr.fileIn.push_back(f[0]);
+		wr.fileOut.assign(f.begin() + 1, f.end());
+		ok = pipeDat(xn, numSamples, (uint32_t)outPath.size(), filter, xodPipeTextOut::write, &wr);
+	}
+	return closeDat(f, path, ok);
+}
+
+// outputs already rendered - out[c][numSamples]
+static bool writeDat(const float* xn, uint32_t numSamples, const string& inPath,
+					 const vector<string>& outPath, const vector<const float*>& out) {
+	uint32_t pos = 0;
+	return writeDat(xn, numSamples, inPath, outPath, [&](const float*, float* const* y, uint32_t n) {
+		for (size_t c = 0; c < out.size(); c++)
+			memcpy(y[c], out[c] + pos, n*sizeof(float));
+		pos += n;
+	});
+}
+
+// inPath <- xn, rowsPath <- one row of numOut values per sample
+template<typename F>
+static bool writeDatRows(const float* xn, uint32_t numSamples, const string& inPath, const string& rowsPath,
+						 uint32_t numOut, const char* fmt, const char* sep, F filter) {
+	vector<string> path = {inPath, rowsPath};
+	vector<FILE*> f = {fopen(inPath.c_str(), "w"), fopen(rowsPath.c_str(), "w")};
+	bool ok = false;
+	if (f[0] && f[1]) {
+		datRowsOut_t wr = {f[0], f[1], numOut, fmt, sep};
+		ok = pipeDat(xn, numSamples, numOut, filter, datRowsOut_t::write, &wr);
+	}
+	return closeDat(f, path, ok);
+}
+
+// worker pool stress - every task of a run counts its own slot
+struct workStress_t {
+	vector<atomic<uint32_t>> hits;
+	workStress_t(size_t n) : hits(n) {}
+	static void task(void* ctx, uint32_t t) {
+		static_cast<workStress_t*>(ctx)->hits[t].fetch_add(1, memory_order_relaxed);
+	}
+};
+
+static string readFileBytes(const string& path) {
+	string s;
+	FILE* f = fopen(path.c_str(), "rb");
+	if (!f)
+		return s;
+	char buf[65536];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+		s.append(buf, n);
+	fclose(f);
+	return s;
+}
+
+
 // *---------------------------------------------------------------------------* //
 ///// Display Help & User Parameters /////////////////////
 
@@ -99,6 +328,7 @@ void printParam(UserParam& param) {
          << "  Cutoff Freq:          " << param.cutoff   						                << endl
          << "  Resonance:            " << param.resonance   					                << endl
          << "  Test Source Type:     " << param.srcType  						                << endl
+         << "  Noise Seed:           " << param.seed  							                << endl
          << endl;
 }
 
@@ -117,11 +347,32 @@ void help(UserParam& param) {
          << "                        - 'LPHP' : Lowpass + Highpass Filter (dual outputs)\n"
          << "                        - 'AP'   : Allpass Filter\n"
          << "                        - 'ML4P' : Moog Ladder 4-Pole Filter\n"
+         << "                        - 'ML4PPOOL' : Moog Ladder 4-Pole polyphonic voice pool\n"
+         << "                        - 'SVF'  : State Variable 2-Pole Filter (LP, BP, HP, NOTCH, PEAK - resonance = Q)\n"
+         << "                        - 'SRBENCH' : per-sample cost & response accuracy at 44.1k - 384k\n"
+         << "                        - 'CKPT' : Moog Ladder 4-Pole render with checkpoints, seek + resume\n"
+         << "                        - 'ML4PMC' : Moog Ladder 4-Pole multi-channel (stereo interleaved, 7.1 planar)\n"
+         << "                        - 'FIXED' : compile-time 777 Hz / 48 kHz LP+HP vs runtime LP+HP, 10 Hz DC blocker\n"
+         << "                        - 'PHASER' : pipelined N-stage All-Pass cascade (resonance = feedback)\n"
+         << "                        - 'XOVER' : single-pass 4-band crossover (1-pole complementary + LR2)\n"
+         << "                        - 'BANK' : SoA 1-pole filterbank, 1k / 10k bands throughput\n"
+         << "                        - 'ML4PMT' : 128 ladder voices, worker pool vs single thread callback latency\n"
+         << "                        - 'GEN'  : signal generator throughput + chunked fill check\n"
+         << "                        - 'ML4PBATCH' : vectorized coefficient recompute, 1024 ladders / 8 ch / 10k bands\n"
+         << "                        - 'GUARD' : blow-up guard - invalid cutoff, NaN / spike injection, guard cost\n"
+         << "                        - 'TUNE' : auto-tuner - calibrate, profile save / load, first-use profile (XODVA_TUNE)\n"
+         << "                        - 'WORKERS' : worker pool stress - task count varies per run, each task exactly once\n"
+         << "                        - 'PIPE' : offline pipeline - overlapped gen / ladder / .dat write vs sequential\n"
+         << "                        - 'GRAPH' : filter graph - fan-out / fan-in patch vs hand-wired, buffer reuse, workers\n"
+         << "                        - 'CAPI' : C ABI wrappers vs C++ filters (ladder, MC, SVF, pool, state)\n"
          << "  -n    <uint32_t>     Number of Samples (test length)\n"
-         << "  -sr   <uint16_t>     Sample Rate\n"
+         << "  -sr   <uint32_t>     Sample Rate (up to 384000)\n"
          << "  -c    <float>        Cutoff Frequency\n"
          << "  -r    <float>        Resonance\n"
-         << "  -s    <uint16_t>     Test Source Type\n"
+         << "  -s    <uint16_t>     Test Source Type:\n"
+         << "                        1 = impulse, 2 = step, 3 = noise, 4 = log sweep, 5 = chirp,\n"
+         << "                        6 = square, 7 = saw, 8 = pink noise\n"
+         << "  -seed <uint64_t>     Noise Seed (source 3, 8)\n"
          << endl;
     printParam(param);
     exit(1);
@@ -147,6 +398,7 @@ int main(int argc, char *argv[])
     param.cutoff    		= 777;
     param.resonance    		= 1.0;
     param.srcType 			= 3;
+    param.seed 				= 1;
 
     vector<string> args;
     for ( int i = 1; i < argc; ++i ) {
@@ -185,6 +437,10 @@ int main(int argc, char *argv[])
             param.srcType = atof(args[++i].c_str());
             continue;
         }
+        if ( args[i] == "-seed" && i+1 < args.size() ) {
+            param.seed = strtoull(args[++i].c_str(), 0, 10);
+            continue;
+        }
         cout << endl << "ERROR: Unknown parameter: " << args[i] << endl;
         help(param);
     }
@@ -197,41 +453,51 @@ int main(int argc, char *argv[])
 		// *---------------------------------------------------------------------------* //
 		///// generate impulse source /////////////////////
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
-
-			if (i==1) {
-				xn[i] = 1;
-			} else {
-				xn[i] = 0;
-			}
-		}
+		xodGenImpulse(xn, param.numSamples, 1);
 
 	} else if (param.srcType==2) {
 		// *---------------------------------------------------------------------------* //
 		///// generate step source /////////////////////
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
-
-			if (i>2) {
-				xn[i] = 1;
-			} else {
-				xn[i] = 0;
-			}
-		}
+		xodGenStep(xn, param.numSamples, 3);
 
 	} else if (param.srcType==3) {
 		// *---------------------------------------------------------------------------* //
-		///// generate random source data /////////////////////
+		///// generate random source data - seeded counter-based noise /////////////////////
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
+		xodGenNoise(xn, param.numSamples, param.seed);
 
-			float r = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+	} else if (param.srcType==4) {
+		// *---------------------------------------------------------------------------* //
+		///// generate log sine sweep 20 Hz -> 0.45 fs /////////////////////
 
-			xn[i] = 2*r-1;
+		xodGenLogSweep(xn, param.numSamples, 20, 0.45*param.sampleRate, param.numSamples, param.sampleRate);
 
-			//cout<<"xnL["<<i<<"] = "<<xnL[i]<<"\txnR["<<i<<"] = "<<xnR[i]<<endl;
+	} else if (param.srcType==5) {
+		// *---------------------------------------------------------------------------* //
+		///// generate linear chirp 0 -> 0.45 fs /////////////////////
 
-		}
+		xodGenChirp(xn, param.numSamples, 0, 0.45*param.sampleRate, param.numSamples, param.sampleRate);
+
+	} else if (param.srcType==6) {
+		// *---------------------------------------------------------------------------* //
+		///// generate 110 Hz square /////////////////////
+
+		xodGenSquare(xn, param.numSamples, 110, param.sampleRate);
+
+	} else if (param.srcType==7) {
+		// *---------------------------------------------------------------------------* //
+		///// generate 110 Hz saw /////////////////////
+
+		xodGenSaw(xn, param.numSamples, 110, param.sampleRate);
+
+	} else if (param.srcType==8) {
+		// *---------------------------------------------------------------------------* //
+		///// generate pink noise /////////////////////
+
+		xodPinkNoise pink;
+		pink.initialize(param.seed);
+		pink.fill(xn, param.numSamples);
 	}
 
 	if(param.type == "LP") {
@@ -241,10 +507,6 @@ int main(int argc, char *argv[])
 
 		printParam(param);
 
-		FILE *f_In, *f_LPOut;
-
-		float ynLP[param.numSamples];
-
 		onePoleTPT_LP vaLPFlt1;
 
 		//float sampleRate = 48000;
@@ -253,33 +515,23 @@ int main(int argc, char *argv[])
 		vaLPFlt1.initialize_LP(param.sampleRate);
 		vaLPFlt1.setFc_LP(param.cutoff);
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
-			vaLPFlt1.doFilterStage_LP(xn[i], ynLP[i]);
-		}
-
 		string filterIn = "xodVAFilterLP_in.dat";
 		string filterOut = "xodVAFilterLP_LPOut.dat";
 
 		string filterIn_fpath = param.dataPath + filterIn;
 		string filterOut_fpath = param.dataPath + filterOut;
 
-		// write reference filter results
-		f_In=fopen(filterIn_fpath.c_str(),"w");
-		f_LPOut=fopen(filterOut_fpath.c_str(),"w");
-
-		for (uint32_t i=0; i<param.numSamples; i++) {
-
-			//cout<<"Ref filter out L: "<<ynL[i]<<"\tRef filter out R: "<<ynR[i]<<endl;
-
-			fprintf(f_In,"%10.7f\n", xn[i]);
-			fprintf(f_LPOut,"%10.7f\n", ynLP[i]);
-		}
-		fclose(f_In);
-		fclose(f_LPOut);
+		// filter and write reference filter results
+		bool ok = writeDat(xn, param.numSamples, filterIn_fpath, {filterOut_fpath},
+						   [&](const float* x, float* const* y, uint32_t n) {
+			for (uint32_t i = 0; i < n; i++) {
+				vaLPFlt1.doFilterStage_LP(x[i], y[0][i]);
+			}
+		});
 
 
 		cout<<endl<<"***** Test complete *****"<<endl;
-		return 0;
+		return ok ? 0 : 1;
 	}
 
 
@@ -290,10 +542,6 @@ int main(int argc, char *argv[])
 
 		printParam(param);
 
-		FILE *f_In, *f_HPOut;
-
-		float ynHP[param.numSamples];
-
 		onePoleTPT_HP vaHPFlt1;
 
 		//float sampleRate = 48000;
@@ -302,33 +550,23 @@ int main(int argc, char *argv[])
 		vaHPFlt1.initialize_HP(param.sampleRate);
 		vaHPFlt1.setFc_HP(param.cutoff);
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
-			vaHPFlt1.doFilterStage_HP(xn[i], ynHP[i]);
-		}
-
 		string filterIn = "xodVAFilterHP_in.dat";
 		string filterOut = "xodVAFilterHP_HPOut.dat";
 
 		string filterIn_fpath = param.dataPath + filterIn;
 		string filterOut_fpath = param.dataPath + filterOut;
 
-		// write reference filter results
-		f_In=fopen(filterIn_fpath.c_str(),"w");
-		f_HPOut=fopen(filterOut_fpath.c_str(),"w");
-
-		for (uint32_t i=0; i<param.numSamples; i++) {
-
-			//cout<<"Ref filter out L: "<<ynL[i]<<"\tRef filter out R: "<<ynR[i]<<endl;
-
-			fprintf(f_In,"%10.7f\n", xn[i]);
-			fprintf(f_HPOut,"%10.7f\n", ynHP[i]);
-		}
-		fclose(f_In);
-		fclose(f_HPOut);
+		// filter and write reference filter results
+		bool ok = writeDat(xn, param.numSamples, filterIn_fpath, {filterOut_fpath},
+						   [&](const float* x, float* const* y, uint32_t n) {
+			for (uint32_t i = 0; i < n; i++) {
+				vaHPFlt1.doFilterStage_HP(x[i], y[0][i]);
+			}
+		});
 		
 
 		cout<<endl<<"***** Test complete *****"<<endl;
-		return 0;
+		return ok ? 0 : 1;
 	}
 
 
@@ -339,11 +577,6 @@ int main(int argc, char *argv[])
 
 		printParam(param);
 
-		FILE *f_In, *f_LPOut, *f_HPOut;
-
-		float ynLP[param.numSamples];
-		float ynHP[param.numSamples];
-
 		onePoleTPT_LPHP vaLPHPFlt1;
 
 		//float sampleRate = 48000;
@@ -352,36 +585,24 @@ int main(int argc, char *argv[])
 		vaLPHPFlt1.initialize_LPHP(param.sampleRate);
 		vaLPHPFlt1.setFc_LPHP(param.cutoff);
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
-			vaLPHPFlt1.doFilterStage_LPHP(xn[i], ynLP[i], ynHP[i]);
-		}
-
 		string filterIn = "xodVAFilterLPHP_in.dat";
 		string filterLPOut = "xodVAFilterLPHP_LPOut.dat";
 		string filterHPOut = "xodVAFilterLPHP_HPOut.dat";
 
-		string filterIn_fpath = param.dataPath + filterLPOut;
+		string filterIn_fpath = param.dataPath + filterIn;
 		string filterLPOut_fpath = param.dataPath + filterLPOut;
 		string filterHPOut_fpath = param.dataPath + filterHPOut;
 
-		// write reference filter results
-		f_In=fopen(filterIn_fpath.c_str(),"w");
-		f_LPOut=fopen(filterLPOut_fpath.c_str(),"w");
-		f_HPOut=fopen(filterHPOut_fpath.c_str(),"w");
-		for (uint32_t i=0; i<param.numSamples; i++) {
-
-			//cout<<"filter out L: "<<ynL[i]<<"\tfilter out R: "<<ynR[i]<<endl;
-
-			fprintf(f_In,"%10.7f\n", xn[i]);
-			fprintf(f_LPOut,"%10.7f\n", ynLP[i]);
-			fprintf(f_HPOut,"%10.7f\n", ynHP[i]);
-		}
-		fclose(f_In);
-		fclose(f_LPOut);
-		fclose(f_HPOut);
+		// filter and write reference filter results
+		bool ok = writeDat(xn, param.numSamples, filterIn_fpath, {filterLPOut_fpath, filterHPOut_fpath},
+						   [&](const float* x, float* const* y, uint32_t n) {
+			for (uint32_t i = 0; i < n; i++) {
+				vaLPHPFlt1.doFilterStage_LPHP(x[i], y[0][i], y[1][i]);
+			}
+		});
 
 		cout<<endl<<"***** Test complete *****"<<endl;
-		return 0;
+		return ok ? 0 : 1;
 
 	}
 
@@ -392,10 +613,6 @@ int main(int argc, char *argv[])
 
 		printParam(param);
 
-		FILE *f_In, *f_APOut;
-
-		float ynAP[param.numSamples];
-
 		onePoleTPT_AP vaAPFlt1;
 
 		//float sampleRate = 48000;
@@ -404,28 +621,19 @@ int main(int argc, char *argv[])
 		vaAPFlt1.initialize_AP(param.sampleRate);
 		vaAPFlt1.setFc_AP(param.cutoff);
 
-		for (uint32_t i = 0; i < param.numSamples; i++) {
-			vaAPFlt1.doFilterStage_AP(xn[i], ynAP[i]);
-		}
-
 		string filterIn = "xodVAFilterAP_in.dat";
 		string filterOut = "xodVAFilterAP_Out.dat";
 
 		string filterIn_fpath = param.dataPath + filterIn;
 		string filterOut_fpath = param.dataPath + filterOut;
 
-		// write reference filter results
-		f_In=fopen(filterIn_fpath.c_str(),"w");
-		f_APOut=fopen(filterOut_fpath.c_str(),"w");
-		for (uint32_t i=0; i<param.numSamples; i++) {
-
-			//cout<<"filter out L: "<<ynL[i]<<"\tfilter out R: "<<ynR[i]<<endl;
-
-			fprintf(f_In,"%10.7f\n", xn[i]);
-			fprintf(f_APOut,"%10.7f\n", ynAP[i]);
-		}
-		fclose(f_In);
-		fclose(f_APOut);
+		// filter and write reference filter results
+		bool ok = writeDat(xn, param.numSamples, filterIn_fpath, {filterOut_fpath},
+						   [&](const float* x, float* const* y, uint32_t n) {
+			for (uint32_t i = 0; i < n; i++) {
+				vaAPFlt1.doFilterStage_AP(x[i], y[0][i]);
+			}
+		});
 
 
 		// *---------------------------------------------------------------------------* //
@@ -456,54 +664,1941 @@ int main(int argc, char *argv[])
 
 
 		cout<<endl<<"***** Test complete *****"<<endl;
-		return 0;
+		return ok ? 0 : 1;
 
 	}
 
 		if(param.type == "ML4P") {
 
 		// *---------------------------------------------------------------------------* //
-		cout << "__(( test Stereo Moog Ladder 4-pole Filter ))__" << endl;
+		cout << "__(( test Moog Ladder 4-pole Filter ))__" << endl;
 
 		printParam(param);
 
-		FILE *f_ML4P_In, *f_ML4P_Out;
+		xodMoogLadder4P MoogL4p;
 
-		float ynML4P[param.numSamples];
+		MoogL4p.initialize(param.sampleRate);
+		MoogL4p.setFcAndRes(param.cutoff, param.resonance, param.sampleRate);
 
-		xodMoogLadder4P MoogL4p;
+#ifdef XODVA_PROFILE
+		xodCycleProfile profML4P;
+		MoogL4p.setProfile(&profML4P);
+#endif
+
+		// filter and write reference filter results
+
+		string moogL4p_in = "moogL4p_in.dat";
+		string moogL4p_inDir = param.dataPath + moogL4p_in;
+
+		string moogL4p_out = "moogL4p_ref_out.dat";
+		string moogL4p_outDir = param.dataPath + moogL4p_out;
+
+		bool ok = writeDat(xn, param.numSamples, moogL4p_inDir, {moogL4p_outDir},
+						   [&](const float* x, float* const* y, uint32_t n) {
+			for (uint32_t i = 0; i < n; i++) {
+				MoogL4p.advance(x[i], y[0][i]);
+			}
+		});
+
+#ifdef XODVA_PROFILE
+		profML4P.dump(cout, "xodMoogLadder4P");
+#endif
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return ok ? 0 : 1;
+
+	}
+
+	if(param.type == "ML4PPOOL") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test Moog Ladder 4-pole Voice Pool ))__" << endl;
+
+		printParam(param);
+
+		// 8 voice arena, 4 notes on, voice 1 released half way through the render
+		const uint32_t maxVoices = 8;
+		const uint32_t numNotes = 4;
+		const uint32_t blockSize = 64;
+
+		xodMoogLadderVoicePool voicePool;
+		voicePool.initialize(maxVoices, param.sampleRate);
+
+#ifdef XODVA_PROFILE
+		xodCycleProfile profPool;
+		voicePool.setProfile(&profPool);
+#endif
+
+		int32_t note[numNotes];
+		for (uint32_t v = 0; v < numNotes; v++) {
+			note[v] = voicePool.acquire();
+			voicePool.voice(note[v]).setFcAndRes(param.cutoff*(v+1), param.resonance, param.sampleRate);
+		}
+
+		// filter and write reference filter results
+
+		string pool_in = "moogL4pPool_in.dat";
+		string pool_inDir = param.dataPath + pool_in;
+
+		string pool_out = "moogL4pPool_out.dat";
+		string pool_outDir = param.dataPath + pool_out;
+
+		// every note filters the same source - inputs are indexed by handle.
+		// the pipeline block is a multiple of blockSize, pos is the stream position
+		uint32_t pos = 0;
+		bool ok = writeDat(xn, param.numSamples, pool_inDir, {pool_outDir},
+						   [&](const float* x, float* const* y, uint32_t numSamples) {
+			for (uint32_t i = 0; i < numSamples; i += blockSize, pos += blockSize) {
+
+				if (voicePool.isActive(note[1]) && (pos >= param.numSamples/2)) {
+					voicePool.release(note[1]);
+					cout<<"released voice handle "<<note[1]<<" at sample "<<pos<<", active voices = "<<voicePool.getNumActive()<<endl;
+				}
+
+				uint32_t n = (numSamples - i < blockSize) ? numSamples - i : blockSize;
+
+				const float* blockIn[maxVoices];
+				for (uint32_t v = 0; v < maxVoices; v++) {
+					blockIn[v] = x + i;
+				}
+				voicePool.processBlockMix(blockIn, &y[0][i], n);
+			}
+		});
+
+#ifdef XODVA_PROFILE
+		profPool.dump(cout, "xodMoogLadderVoicePool (all voices)");
+#endif
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return ok ? 0 : 1;
+
+	}
+
+	if(param.type == "SVF") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test State Variable 2-pole Filter ))__" << endl;
+
+		printParam(param);
+
+		float ynLP[param.numSamples];
+		float ynBP[param.numSamples];
+		float ynHP[param.numSamples];
+		float ynNOTCH[param.numSamples];
+		float ynPEAK[param.numSamples];
+
+		svfBlockOut_t ynSVF = {ynLP, ynBP, ynHP, ynNOTCH, ynPEAK};
+
+		xodSVF2P vaSVFFlt1;
+
+		vaSVFFlt1.initialize_SVF(param.sampleRate);
+		vaSVFFlt1.setFcAndQ_SVF(param.cutoff, param.resonance);
+		vaSVFFlt1.processBlock_SVF(xn, ynSVF, param.numSamples);
+
+
+		// multi-voice SVF - lane l runs at cutoff*(l+1), compare each lane with the scalar SVF
+		xodSVF2P_MV vaSVFMV;
+		vaSVFMV.initialize_SVF(param.sampleRate);
+
+		vector<float> xnMV(param.numSamples*xodSimdLanes);
+		vector<float> ynMV(param.numSamples*xodSimdLanes);
+		for (uint32_t i = 0; i < param.numSamples; i++) {
+			for (uint32_t l = 0; l < xodSimdLanes; l++) {
+				xnMV[i*xodSimdLanes + l] = xn[i];
+			}
+		}
+
+		// every response: multi-voice lanes and the all-responses block vs the scalar
+		// single-response block
+		const float svfTol = 1e-5f;
+		const char* svfName[5] = {"LP", "BP", "HP", "NOTCH", "PEAK"};
+		const float* ynAll[5] = {ynLP, ynBP, ynHP, ynNOTCH, ynPEAK};
+		uint32_t failed = 0;
+		for (uint32_t l = 0; l < xodSimdLanes; l++) {
+			vaSVFMV.setFcAndQ_SVF(l, param.cutoff*(l+1), param.resonance);
+		}
+		vector<float> ynRef(param.numSamples);
+		for (uint32_t t = SVF_LP; t <= SVF_PEAK; t++) {
+			float maxErrMV = 0, maxErrAll = 0;
+			vaSVFMV.reset_SVF();
+			vaSVFMV.processBlock_SVF(&xnMV[0], &ynMV[0], param.numSamples, (svfType)t);
+
+			for (uint32_t l = 0; l < xodSimdLanes; l++) {
+				xodSVF2P svfRef;
+				svfRef.initialize_SVF(param.sampleRate);
+				svfRef.setFcAndQ_SVF(param.cutoff*(l+1), param.resonance);
+				svfRef.processBlock_SVF(xn, &ynRef[0], param.numSamples, (svfType)t);
+				for (uint32_t i = 0; i < param.numSamples; i++) {
+					maxErrMV = max(maxErrMV, fabsf(ynMV[i*xodSimdLanes + l] - ynRef[i]));
+					if (l == 0)
+						maxErrAll = max(maxErrAll, fabsf(ynAll[t][i] - ynRef[i]));
+				}
+			}
+			cout<<"SVF "<<svfName[t]<<": multi-voice ("<<xodSimdLanes<<" lanes) max error vs scalar = "<<maxErrMV
+				<<", all-responses block max error = "<<maxErrAll<<endl;
+			failed += (maxErrMV > svfTol) || (maxErrAll > svfTol);
+		}
+
+
+		string filterIn_fpath = param.dataPath + "xodVAFilterSVF_in.dat";
+		string filterLPOut_fpath = param.dataPath + "xodVAFilterSVF_LPOut.dat";
+		string filterBPOut_fpath = param.dataPath + "xodVAFilterSVF_BPOut.dat";
+		string filterHPOut_fpath = param.dataPath + "xodVAFilterSVF_HPOut.dat";
+		string filterNOTCHOut_fpath = param.dataPath + "xodVAFilterSVF_NOTCHOut.dat";
+		string filterPEAKOut_fpath = param.dataPath + "xodVAFilterSVF_PEAKOut.dat";
+
+		// write reference filter results
+		failed += !writeDat(xn, param.numSamples, filterIn_fpath,
+							{filterLPOut_fpath, filterBPOut_fpath, filterHPOut_fpath, filterNOTCHOut_fpath, filterPEAKOut_fpath},
+							{ynLP, ynBP, ynHP, ynNOTCH, ynPEAK});
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "SRBENCH") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( benchmark sample rates 44.1k - 384k ))__" << endl;
+
+		printParam(param);
+
+		// ideal 1-pole LP response at fc is -3.0103 dB for every rate
+		const double ideal_dB = -10*log10(2.0);
+		const float testCutoff[2] = {20, param.cutoff};
+
+		float ynB[param.numSamples];
+
+		cout<<endl<<"per-sample cost (ns) - LP, ML4P, SVF ; cutoff = "<<param.cutoff<<endl;
+		cout<<"  fs        LP        ML4P      SVF"<<endl;
+
+#ifdef XODVA_PROFILE
+		xodCycleProfile profBench;
+#endif
+
+		for (uint32_t r = 0; r < xodNumStdRates; r++) {
+			float fs = xodStdRates[r];
+
+			onePoleTPT_LP benchLP;
+			benchLP.initialize_LP(fs);
+			benchLP.setFc_LP(param.cutoff);
+
+			xodMoogLadder4P benchML4P;
+			benchML4P.initialize(fs);
+			benchML4P.setFcAndRes(param.cutoff, param.resonance, fs);
+#ifdef XODVA_PROFILE
+			// profile the first rate only - rdtscp per section inflates the timings below
+			if (r == 0)
+				benchML4P.setProfile(&profBench);
+#endif
+
+			xodSVF2P benchSVF;
+			benchSVF.initialize_SVF(fs);
+			benchSVF.setFcAndQ_SVF(param.cutoff, param.resonance);
+
+			double nsLP = nsPerSample([&]() {
+				for (uint32_t i = 0; i < param.numSamples; i++) benchLP.doFilterStage_LP(xn[i], ynB[i]);
+			}, param.numSamples);
+			double nsML4P = nsPerSample([&]() {
+				benchML4P.advanceBlock(xn, ynB, param.numSamples);
+			}, param.numSamples);
+			double nsSVF = nsPerSample([&]() {
+				benchSVF.processBlock_SVF(xn, ynB, param.numSamples, SVF_LP);
+			}, param.numSamples);
+
+			printf("  %-8.0f  %-8.3f  %-8.3f  %-8.3f\n", fs, nsLP, nsML4P, nsSVF);
+		}
+
+#ifdef XODVA_PROFILE
+		profBench.dump(cout, "xodMoogLadder4P @ 44100");
+#endif
+
+		cout<<endl<<"1-pole LP G error (ulp) and response error at fc (dB vs ideal -3.0103) - float path vs double path"<<endl;
+		cout<<"  fs        fc        G float       G double      ulp float  ulp double  dB float      dB double"<<endl;
+
+		// the double path rounds G once (<= 0.5 ulp at every rate); the float
+		// path rounds pi*fc/fs and the (2/T)*tan()*T/2 round trip in float
+		uint32_t failed = 0;
+		double maxUlpD = 0;
+		double maxUlpF384 = 0, maxUlpD384 = 0;
+		for (uint32_t r = 0; r < xodNumStdRates; r++) {
+			double fs = xodStdRates[r];
+			for (uint32_t k = 0; k < 2; k++) {
+				float Gf = onePoleTPT_G(fs, testCutoff[k]);
+				float Gd = onePoleTPT_calcG(testCutoff[k], pi/fs);
+				double ulpF = onePoleTPT_G_ulp(Gf, testCutoff[k], fs);
+				double ulpD = onePoleTPT_G_ulp(Gd, testCutoff[k], fs);
+				double errF = onePoleLP_gain_dB(Gf, testCutoff[k], fs) - ideal_dB;
+				double errD = onePoleLP_gain_dB(Gd, testCutoff[k], fs) - ideal_dB;
+				printf("  %-8.0f  %-8.1f  %-12.6e  %-12.6e  %-9.3f  %-10.3f  %+-12.3e  %+-12.3e\n",
+					   fs, testCutoff[k], Gf, Gd, ulpF, ulpD, errF, errD);
+				maxUlpD = max(maxUlpD, ulpD);
+				if (fs == 384000) {
+					maxUlpF384 = max(maxUlpF384, ulpF);
+					maxUlpD384 = max(maxUlpD384, ulpD);
+				}
+			}
+		}
+		cout<<"double path max G error = "<<maxUlpD<<" ulp ; 384 kHz max G error: float "<<maxUlpF384
+			<<" ulp, double "<<maxUlpD384<<" ulp"<<endl;
+		failed += !(maxUlpD <= 0.5 + 1e-6);
+		failed += !(maxUlpF384 > maxUlpD384);
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "CKPT") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test Moog Ladder 4-pole checkpointed render ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t blockSize = 64;
+		const uint64_t interval = 16*blockSize;
 
+		float ynRef[param.numSamples];
+		float ynSeek[param.numSamples];
+
+		// full render, checkpoint every interval samples
+		xodMoogLadder4P MoogL4p;
 		MoogL4p.initialize(param.sampleRate);
 		MoogL4p.setFcAndRes(param.cutoff, param.resonance, param.sampleRate);
 
+		xodCheckpointer<xodMoogLadder4P> ckpt;
+		ckpt.initialize(interval);
+
+		for (uint32_t i = 0; i < param.numSamples; i += blockSize) {
+			uint32_t n = (param.numSamples - i < blockSize) ? param.numSamples - i : blockSize;
+			ckpt.update(MoogL4p, i);
+			MoogL4p.advanceBlock(&xn[i], &ynRef[i], n);
+		}
+		cout<<"checkpoints: "<<ckpt.getNumCheckpoints()<<" x "<<ckpt.getSnapshot(0).size()<<" bytes"<<endl;
+
+		// seek: restore nearest checkpoint, re-run only the remainder
+		uint32_t seekPos = (param.numSamples*7)/10;
+		uint64_t from = ckpt.restore(MoogL4p, seekPos);
+		MoogL4p.advanceBlock(&xn[from], &ynSeek[from], param.numSamples - from);
+
+		uint32_t mismatch = 0;
+		for (uint32_t i = from; i < param.numSamples; i++) {
+			if (ynSeek[i] != ynRef[i]) mismatch++;
+		}
+		cout<<"seek to "<<seekPos<<": restored checkpoint @ "<<from<<", re-ran "<<param.numSamples - from
+			<<" samples, mismatches vs full render = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// resume an interrupted render from the checkpoint file with a fresh ladder
+		string ckptPath = param.dataPath + "moogL4p_ckpt.bin";
+		ckpt.writeFile(ckptPath.c_str());
+
+		xodCheckpointer<xodMoogLadder4P> ckptResume;
+		xodMoogLadder4P MoogL4pResume;
+		MoogL4pResume.initialize(param.sampleRate);
+		if (!ckptResume.readFile(ckptPath.c_str())) {
+			cout<<"ERROR: failed to read "<<ckptPath<<endl;
+			return 1;
+		}
+		uint64_t resumePos = ckptResume.restore(MoogL4pResume, param.numSamples);
+		MoogL4pResume.advanceBlock(&xn[resumePos], &ynSeek[resumePos], param.numSamples - resumePos);
 
+		mismatch = 0;
+		for (uint32_t i = resumePos; i < param.numSamples; i++) {
+			if (ynSeek[i] != ynRef[i]) mismatch++;
+		}
+		cout<<"resume from file @ "<<resumePos<<": mismatches vs full render = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// bank snapshot is deterministic - same state, same bytes
+		xodMoogLadderVoicePool voicePool;
+		voicePool.initialize(8, param.sampleRate);
+		for (uint32_t v = 0; v < 3; v++) {
+			voicePool.voice(voicePool.acquire()).setFcAndRes(param.cutoff*(v+1), param.resonance, param.sampleRate);
+		}
+		vector<uint8_t> snapA, snapB;
+		xodStateWriter wA(snapA);
+		voicePool.saveState(wA);
+		xodMoogLadderVoicePool voicePoolCopy;
+		voicePoolCopy.initialize(8, param.sampleRate);
+		xodStateReader rA(snapA);
+		voicePoolCopy.loadState(rA);
+		xodStateWriter wB(snapB);
+		voicePoolCopy.saveState(wB);
+		cout<<"voice pool snapshot: "<<snapA.size()<<" bytes, save/load/save identical = "<<(snapA == snapB ? "yes" : "no")<<endl;
+		failed += (snapA != snapB);
+
+		// corrupt / truncated snapshots are rejected and leave the target untouched
+		auto snapOf = [](auto& flt) {
+			vector<uint8_t> b;
+			xodStateWriter w(b);
+			flt.saveState(w);
+			return b;
+		};
+		uint32_t rejected = 0, untouched = 0, numCorrupt = 0;
+		auto tryLoad = [&](auto& flt, const vector<uint8_t>& bad) {
+			vector<uint8_t> before = snapOf(flt);
+			xodStateReader r(bad);
+			rejected += !flt.loadState(r);
+			untouched += (snapOf(flt) == before);
+			numCorrupt++;
+		};
+
+		vector<uint8_t> badPool = snapA;
+		int32_t badHandle = 99;
+		memcpy(&badPool[16], &badHandle, sizeof(badHandle));		// slotToHandle[0] out of range
+		tryLoad(voicePoolCopy, badPool);
+		badPool = snapA;
+		uint32_t badActive = 7;
+		memcpy(&badPool[4], &badActive, sizeof(badActive));			// numActive + numFree != capacity
+		tryLoad(voicePoolCopy, badPool);
+		badPool = snapA;
+		swap(badPool[16], badPool[20]);								// slot / handle maps not inverse
+		tryLoad(voicePoolCopy, badPool);
+		tryLoad(voicePoolCopy, vector<uint8_t>(snapA.begin(), snapA.end() - 5));
+
+		vector<uint8_t> ladderSnap = snapOf(MoogL4p);
+		tryLoad(MoogL4pResume, vector<uint8_t>(ladderSnap.begin(), ladderSnap.end() - 1));
+
+		xodMoogLadder4P_MC mcCk;
+		mcCk.initialize(2, param.sampleRate);
+		vector<uint8_t> badMC = snapOf(mcCk);
+		uint32_t badChannels = 100;
+		memcpy(&badMC[0], &badChannels, sizeof(badChannels));
+		tryLoad(mcCk, badMC);
+
+		xodOnePoleBank bankCk;
+		bankCk.initialize(40, param.sampleRate);
+		bankCk.setFc(0, param.cutoff);
+		vector<uint8_t> badBank = snapOf(bankCk);
+		uint32_t badBands = 0xffffffffu;
+		memcpy(&badBank[0], &badBands, sizeof(badBands));				// huge band count
+		tryLoad(bankCk, badBank);
+		badBank = snapOf(bankCk);
+		badBands = 41;
+		memcpy(&badBank[0], &badBands, sizeof(badBands));				// band count past the data
+		tryLoad(bankCk, badBank);
+		badBank = snapOf(bankCk);
+		tryLoad(bankCk, vector<uint8_t>(badBank.begin(), badBank.end() - 4));
+
+		xodCrossover xoCk;
+		xoCk.initialize(4, XOVER_LR2, param.sampleRate);
+		const float xoSplits[3] = {200, 1000, 5000};
+		xoCk.setSplits(xoSplits);
+		vector<uint8_t> badXo = snapOf(xoCk);
+		uint32_t badXoType = 9;
+		memcpy(&badXo[0], &badXoType, sizeof(badXoType));				// unknown type
+		tryLoad(xoCk, badXo);
+		badXo = snapOf(xoCk);
+		uint32_t badXoBands = 1000;
+		memcpy(&badXo[4], &badXoBands, sizeof(badXoBands));			// band count out of range
+		tryLoad(xoCk, badXo);
+		badXo = snapOf(xoCk);
+		tryLoad(xoCk, vector<uint8_t>(badXo.begin(), badXo.end() - 8));
+		cout<<"corrupt snapshots: rejected "<<rejected<<" of "<<numCorrupt<<", target untouched "<<untouched<<" of "<<numCorrupt<<endl;
+		failed += (rejected != numCorrupt) + (untouched != numCorrupt);
+
+		// checkpoint file with a huge snapshot length / truncated - readFile fails, checkpoints kept
+		vector<uint8_t> fileBytes;
+		{
+			string fb = readFileBytes(ckptPath);
+			fileBytes.assign(fb.begin(), fb.end());
+		}
+		string badPath = param.dataPath + "moogL4p_ckpt_bad.bin";
+		uint32_t fileRejected = 0;
+		for (uint32_t k = 0; k < 2; k++) {
+			vector<uint8_t> bad = fileBytes;
+			if (k == 0) {
+				uint32_t hugeLen = 0xfffffff0u;
+				memcpy(&bad[8 + 8 + 4 + 8], &hugeLen, sizeof(hugeLen));	// first snapshot length
+			} else {
+				bad.resize(bad.size() - 3);
+			}
+			FILE* fb = fopen(badPath.c_str(), "wb");
+			fwrite(bad.data(), 1, bad.size(), fb);
+			fclose(fb);
+			uint32_t numBefore = ckptResume.getNumCheckpoints();
+			fileRejected += !ckptResume.readFile(badPath.c_str()) && ckptResume.getNumCheckpoints() == numBefore;
+		}
+		cout<<"corrupt checkpoint files: rejected with checkpoints kept "<<fileRejected<<" of 2"<<endl;
+		failed += (fileRejected != 2);
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "ML4PMC") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test Multi-channel Moog Ladder 4-pole Filter ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		// reference - one mono ladder per channel, channel ch at cutoff*(ch+1)
+		vector<float> ynRef(param.numSamples*xodSimdLanes);
+		for (uint32_t ch = 0; ch < xodSimdLanes; ch++) {
+			xodMoogLadder4P MoogL4p;
+			MoogL4p.initialize(param.sampleRate);
+			MoogL4p.setFcAndRes(param.cutoff*(ch+1), param.resonance, param.sampleRate);
+			MoogL4p.advanceBlock(xn, &ynRef[ch*param.numSamples], param.numSamples);
+		}
+
+		// stereo interleaved, in place, per-channel cutoff
+		vector<float> ynStereo(2*param.numSamples);
+		for (uint32_t i = 0; i < param.numSamples; i++) {
+			ynStereo[2*i] = xn[i];
+			ynStereo[2*i + 1] = xn[i];
+		}
+		xodMoogLadder4P_MC MoogL4pStereo;
+		MoogL4pStereo.initialize(2, param.sampleRate);
+		MoogL4pStereo.setFcAndRes(0, param.cutoff, param.resonance);
+		MoogL4pStereo.setFcAndRes(1, param.cutoff*2, param.resonance);
+
+		// channels past numChannels are ignored - the snapshot is unchanged
+		vector<uint8_t> snapBefore, snapAfter;
+		xodStateWriter wBefore(snapBefore), wAfter(snapAfter);
+		MoogL4pStereo.saveState(wBefore);
+		MoogL4pStereo.setFcAndRes(2, param.cutoff*3, param.resonance);
+		MoogL4pStereo.setFcAndRes(xodSimdLanes, param.cutoff*3, param.resonance);
+		MoogL4pStereo.setFcAndRes(0xffffffffu, param.cutoff*3, param.resonance);
+		MoogL4pStereo.saveState(wAfter);
+		cout<<"setFcAndRes on channels >= 2 changed the stereo ladder: "<<((snapBefore != snapAfter) ? "yes" : "no")<<endl;
+		failed += (snapBefore != snapAfter);
+
+		MoogL4pStereo.processInterleaved(&ynStereo[0], param.numSamples);
+
+		float maxErrStereo = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++) {
+			for (uint32_t ch = 0; ch < 2; ch++) {
+				maxErrStereo = max(maxErrStereo, fabsf(ynStereo[2*i + ch] - ynRef[ch*param.numSamples + i]));
+			}
+		}
+		cout<<"stereo interleaved max error vs mono ladders = "<<maxErrStereo<<endl;
+		failed += (maxErrStereo != 0);
+
+		// 7.1 planar, in place
+		vector<float> ynPlanar(xodSimdLanes*param.numSamples);
+		float* chan[xodSimdLanes];
+		for (uint32_t ch = 0; ch < xodSimdLanes; ch++) {
+			chan[ch] = &ynPlanar[ch*param.numSamples];
+			for (uint32_t i = 0; i < param.numSamples; i++)
+				chan[ch][i] = xn[i];
+		}
+		xodMoogLadder4P_MC MoogL4p71;
+		MoogL4p71.initialize(xodSimdLanes, param.sampleRate);
+		for (uint32_t ch = 0; ch < xodSimdLanes; ch++)
+			MoogL4p71.setFcAndRes(ch, param.cutoff*(ch+1), param.resonance);
+		MoogL4p71.processPlanar(chan, param.numSamples);
+
+		float maxErrPlanar = 0;
+		for (uint32_t i = 0; i < xodSimdLanes*param.numSamples; i++)
+			maxErrPlanar = max(maxErrPlanar, fabsf(ynPlanar[i] - ynRef[i]));
+		cout<<xodSimdLanes<<" ch planar max error vs mono ladders = "<<maxErrPlanar<<endl;
+		failed += (maxErrPlanar != 0);
+
+		// cost per frame - mono ladder vs stereo / 8 ch interleaved lane groups
+		vector<float> bufBench(xodSimdLanes*param.numSamples, 0.0f);
+		xodMoogLadder4P benchMono;
+		benchMono.initialize(param.sampleRate);
+		benchMono.setFcAndRes(param.cutoff, param.resonance, param.sampleRate);
+		xodMoogLadder4P_MC benchStereo, bench8;
+		benchStereo.initialize(2, param.sampleRate);
+		benchStereo.setFcAndRes(param.cutoff, param.resonance);
+		bench8.initialize(xodSimdLanes, param.sampleRate);
+		bench8.setFcAndRes(param.cutoff, param.resonance);
+		for (uint32_t i = 0; i < xodSimdLanes*param.numSamples; i++)
+			bufBench[i] = xn[i % param.numSamples];
+
+		double nsMono = nsPerSample([&]() {
+			benchMono.advanceBlock(&bufBench[0], &bufBench[0], param.numSamples);
+		}, param.numSamples);
+		double nsStereo = nsPerSample([&]() {
+			benchStereo.processInterleaved(&bufBench[0], param.numSamples);
+		}, param.numSamples);
+		double ns8 = nsPerSample([&]() {
+			bench8.processInterleaved(&bufBench[0], param.numSamples);
+		}, param.numSamples);
+		printf("ns/frame: mono %.3f, stereo %.3f, %u ch %.3f\n", nsMono, nsStereo, xodSimdLanes, ns8);
+
+
+		// write stereo results - one line per frame: L R
+		string mc_in = "moogL4pMC_in.dat";
+		string mc_inDir = param.dataPath + mc_in;
+
+		string mc_out = "moogL4pMC_stereo_out.dat";
+		string mc_outDir = param.dataPath + mc_out;
+
+		uint32_t pos = 0;
+		failed += !writeDatRows(xn, param.numSamples, mc_inDir, mc_outDir, 2, "%10.7f", " ",
+								[&](const float*, float* const* y, uint32_t n) {
+			for (uint32_t i = 0; i < n; i++, pos++) {
+				y[0][i] = ynStereo[2*pos];
+				y[1][i] = ynStereo[2*pos + 1];
+			}
+		});
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "FIXED") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test fixed-cutoff (constexpr) Low-Pass + High-Pass filter ))__" << endl;
+
+		// cutoff / sample rate are template parameters - -c / -sr are ignored
+		const uint32_t fixedCutoff = 777;
+		const uint32_t fixedSampleRate = 48000;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		float ynLP[param.numSamples];
+		float ynHP[param.numSamples];
+		float ynDC[param.numSamples];
+		float ynLPRef[param.numSamples];
+		float ynHPRef[param.numSamples];
+
+		onePoleTPT_fixed<fixedCutoff, fixedSampleRate> vaLPHPFixed;
+
+		onePoleTPT_LPHP vaLPHPRef;
+		vaLPHPRef.initialize_LPHP(fixedSampleRate);
+		vaLPHPRef.setFc_LPHP(fixedCutoff);
+
+		double nsFixed = nsPerSample([&]() {
+			for (uint32_t i = 0; i < param.numSamples; i++) vaLPHPFixed.doFilterStage_LPHP(xn[i], ynLP[i], ynHP[i]);
+		}, param.numSamples);
+		double nsRef = nsPerSample([&]() {
+			for (uint32_t i = 0; i < param.numSamples; i++) vaLPHPRef.doFilterStage_LPHP(xn[i], ynLPRef[i], ynHPRef[i]);
+		}, param.numSamples);
+
+		uint32_t mismatch = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++) {
+			if (ynLP[i] != ynLPRef[i] || ynHP[i] != ynHPRef[i]) mismatch++;
+		}
+		cout<<"constexpr G = "<<vaLPHPFixed.G<<", mismatches vs runtime LP+HP = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+		printf("ns/sample: constexpr %.3f, runtime %.3f\n", nsFixed, nsRef);
+
+		xodDCBlocker<fixedSampleRate> dcBlock;
 		for (uint32_t i = 0; i < param.numSamples; i++) {
-			MoogL4p.advance(xn[i], ynML4P[i]);
+			dcBlock.doFilterStage_HP(xn[i] + 0.5f, ynDC[i]);
 		}
 
+		string filterIn_fpath = param.dataPath + "xodVAFilterFIXED_in.dat";
+		string filterLPOut_fpath = param.dataPath + "xodVAFilterFIXED_LPOut.dat";
+		string filterHPOut_fpath = param.dataPath + "xodVAFilterFIXED_HPOut.dat";
+		string filterDCOut_fpath = param.dataPath + "xodVAFilterFIXED_DCBlockOut.dat";
 
 		// write reference filter results
+		failed += !writeDat(xn, param.numSamples, filterIn_fpath,
+							{filterLPOut_fpath, filterHPOut_fpath, filterDCOut_fpath}, {ynLP, ynHP, ynDC});
 
-		string moogL4p_in = "moogL4p_in.dat";
-		string moogL4p_inDir = param.dataPath + moogL4p_in;
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
 
-		string moogL4p_out = "moogL4p_ref_out.dat";
-		string moogL4p_outDir = param.dataPath + moogL4p_out;
+	}
 
-		f_ML4P_In=fopen(moogL4p_inDir.c_str(),"w");
-		f_ML4P_Out=fopen(moogL4p_outDir.c_str(),"w");
+	if(param.type == "PHASER") {
 
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test pipelined All-Pass cascade (phaser) ))__" << endl;
 
-		for (uint32_t i=0;i<param.numSamples;i++) {
-			fprintf(f_ML4P_In,"%10.7f\n", xn[i]);
-			fprintf(f_ML4P_Out,"%10.7f\n", ynML4P[i]);
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t numStages = 12;
+		const uint32_t blockSize = 64;
+
+		float ynPipe[param.numSamples];
+		float ynSer[param.numSamples];
+
+		// pipelined wet output == serial wet output delayed by the latency
+		xodAllPassCascade apPipe, apSer;
+		apPipe.initialize(numStages, param.sampleRate);
+		apSer.initialize(numStages, param.sampleRate);
+		apPipe.setCutoffs(param.cutoff, 1.25);
+		apSer.setCutoffs(param.cutoff, 1.25);
+		apPipe.setMix(1);
+		apSer.setMix(1);
+		apPipe.processBlock(xn, ynPipe, param.numSamples);
+		apSer.processBlockSerial(xn, ynSer, param.numSamples);
+
+		uint32_t lat = apPipe.getLatency();
+		uint32_t mismatch = 0;
+		for (uint32_t i = lat; i < param.numSamples; i++) {
+			if (ynPipe[i] != ynSer[i - lat]) mismatch++;
+		}
+		cout<<numStages<<" stages, latency "<<lat<<" samples, mismatches vs serial cascade = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// cost per sample: pipelined vs serial
+		const uint32_t benchStages[3] = {4, 12, 24};
+		for (uint32_t b = 0; b < 3; b++) {
+			xodAllPassCascade benchAP;
+			benchAP.initialize(benchStages[b], param.sampleRate);
+			benchAP.setCutoffs(param.cutoff, 1.1);
+			double nsPipe = nsPerSample([&]() {
+				benchAP.processBlock(xn, ynPipe, param.numSamples);
+			}, param.numSamples);
+			double nsSer = nsPerSample([&]() {
+				benchAP.processBlockSerial(xn, ynSer, param.numSamples);
+			}, param.numSamples);
+			printf("%2u stages ns/sample: pipelined %.3f, serial %.3f\n", benchStages[b], nsPipe, nsSer);
 		}
 
-		fclose(f_ML4P_In);
-		fclose(f_ML4P_Out);
+		// phaser - 0.5 Hz sine LFO sampled once per block, 2 octave sweep
+		xodAllPassCascade phaser;
+		phaser.initialize(numStages, param.sampleRate);
+		phaser.setCutoffs(param.cutoff, 1.25);
+		phaser.setDepth(2);
+		phaser.setFeedback(param.resonance > 0.95 ? 0.95 : param.resonance);
+
+		string filterIn_fpath = param.dataPath + "xodVAFilterPHASER_in.dat";
+		string filterOut_fpath = param.dataPath + "xodVAFilterPHASER_Out.dat";
+
+		// the pipeline block is a multiple of blockSize, pos is the stream position
+		uint32_t pos = 0;
+		failed += !writeDat(xn, param.numSamples, filterIn_fpath, {filterOut_fpath},
+							[&](const float* x, float* const* y, uint32_t numSamples) {
+			for (uint32_t i = 0; i < numSamples; i += blockSize, pos += blockSize) {
+				uint32_t n = (numSamples - i < blockSize) ? numSamples - i : blockSize;
+				phaser.modulate(sin(2*pi*0.5*pos/param.sampleRate));
+				phaser.processBlock(&x[i], &y[0][i], n);
+			}
+		});
 
 		cout<<endl<<"***** Test complete *****"<<endl;
-		return 0;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "XOVER") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test single-pass multiband crossover ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t numBands = 4;
+		const float splitFc[xodCrossover::maxBands - 1] = {param.cutoff, 4*param.cutoff, 16*param.cutoff,
+														   32*param.cutoff, 64*param.cutoff, 128*param.cutoff, 256*param.cutoff};
+
+		vector<float> bandBuf(xodCrossover::maxBands*param.numSamples);
+		float* band[xodCrossover::maxBands];
+		for (uint32_t k = 0; k < xodCrossover::maxBands; k++)
+			band[k] = &bandBuf[k*param.numSamples];
+
+		// complementary 1-pole bands sum back to the input
+		xodCrossover xover1P;
+		xover1P.initialize(numBands, XOVER_1POLE, param.sampleRate);
+		xover1P.setSplits(splitFc);
+		xover1P.processBlock(xn, band, param.numSamples);
+
+		float maxErr1P = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++) {
+			float sum = 0;
+			for (uint32_t k = 0; k < numBands; k++)
+				sum += band[k][i];
+			maxErr1P = max(maxErr1P, fabsf(sum - xn[i]));
+		}
+		cout<<numBands<<"-band 1-pole crossover: max |sum(bands) - x| = "<<maxErr1P<<endl;
+		failed += !(maxErr1P < 1e-6f);
+
+		// 2-band LR2: LP2 - HP2 is the 1-pole all-pass at the split
+		float ynAP[param.numSamples];
+		onePoleTPT_AP apRef;
+		apRef.initialize_AP(param.sampleRate);
+		apRef.setFc_AP(splitFc[0]);
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			apRef.doFilterStage_AP(xn[i], ynAP[i]);
+
+		xodCrossover xoverLR2;
+		xoverLR2.initialize(2, XOVER_LR2, param.sampleRate);
+		xoverLR2.setSplits(splitFc);
+		xoverLR2.processBlock(xn, band, param.numSamples);
+
+		float maxErrLR2 = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			maxErrLR2 = max(maxErrLR2, fabsf(band[0][i] + band[1][i] - ynAP[i]));
+		cout<<"2-band LR2 crossover: max |sum(bands) - allpass| = "<<maxErrLR2<<endl;
+		failed += !(maxErrLR2 < 1e-5f);
+
+		// cost: single pass vs one onePoleTPT_LPHP object + buffer pass per split
+		const uint32_t benchBands[2] = {4, 8};
+		for (uint32_t b = 0; b < 2; b++) {
+			uint32_t nb = benchBands[b];
+
+			xodCrossover benchXover;
+			benchXover.initialize(nb, XOVER_1POLE, param.sampleRate);
+			benchXover.setSplits(splitFc);
+			double nsSingle = nsPerSample([&]() {
+				benchXover.processBlock(xn, band, param.numSamples);
+			}, param.numSamples);
+
+			onePoleTPT_LPHP splitLPHP[xodCrossover::maxBands];
+			for (uint32_t k = 0; k + 1 < nb; k++) {
+				splitLPHP[k].initialize_LPHP(param.sampleRate);
+				splitLPHP[k].setFc_LPHP(splitFc[k]);
+			}
+			double nsMulti = nsPerSample([&]() {
+				float hp;
+				for (uint32_t k = 0; k + 1 < nb; k++) {
+					for (uint32_t i = 0; i < param.numSamples; i++)
+						splitLPHP[k].doFilterStage_LPHP(xn[i], band[k + 1][i], hp);
+				}
+				for (uint32_t i = 0; i < param.numSamples; i++) {
+					float prev = 0;
+					for (uint32_t k = 0; k + 1 < nb; k++) {
+						float lp = band[k + 1][i];
+						band[k][i] = lp - prev;
+						prev = lp;
+					}
+					band[nb - 1][i] = xn[i] - prev;
+				}
+			}, param.numSamples);
+
+			printf("%u bands ns/sample: single pass %.3f, pass per split %.3f\n", nb, nsSingle, nsMulti);
+		}
+
+		// write 4-band 1-pole results - one row of bands per sample
+		xover1P.reset();
+		failed += !writeDatRows(xn, param.numSamples, param.dataPath + "xodVAFilterXOVER_in.dat",
+								param.dataPath + "xodVAFilterXOVER_bandsOut.dat", numBands, "%10.7f ", "",
+								[&](const float* x, float* const* y, uint32_t n) {
+			xover1P.processBlock(x, y, n);
+		});
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "BANK") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test SoA 1-pole filterbank ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t blockSize = 64;
+		const uint32_t benchBands[2] = {1024, 10000};
+
+		for (uint32_t b = 0; b < 2; b++) {
+			uint32_t nb = benchBands[b];
+
+			// log spaced cutoffs 20 Hz .. 0.45 fs
+			vector<float> fc(nb);
+			for (uint32_t k = 0; k < nb; k++)
+				fc[k] = 20*pow(0.45*param.sampleRate/20, (double)k/(nb - 1));
+
+			xodOnePoleBank bank;
+			bank.initialize(nb, param.sampleRate);
+			bank.setFc(&fc[0]);
+			uint32_t stride = bank.getStride();
+
+			vector<float> ynBank((size_t)blockSize*stride);
+			vector<float> xnBands((size_t)blockSize*stride);
+
+			// check a few bands against onePoleTPT_LP over the first block
+			bank.processBlock(xn, &ynBank[0], blockSize, BANK_LP);
+			float maxErr = 0;
+			for (uint32_t k = 0; k < nb; k += nb/7) {
+				onePoleTPT_LP ref;
+				ref.initialize_LP(param.sampleRate);
+				ref.setFc_LP(fc[k]);
+				for (uint32_t i = 0; i < blockSize; i++) {
+					float y;
+					ref.doFilterStage_LP(xn[i], y);
+					maxErr = max(maxErr, fabsf(y - ynBank[(size_t)i*stride + k]));
+				}
+			}
+
+			// shared input - all bands from one signal
+			uint32_t numBlocks = param.numSamples/blockSize;
+			double nsShared = nsPerSample([&]() {
+				for (uint32_t blk = 0; blk < numBlocks; blk++)
+					bank.processBlock(&xn[blk*blockSize], &ynBank[0], blockSize, BANK_LP);
+			}, numBlocks*blockSize);
+
+			// per-band input - smoothers
+			for (size_t i = 0; i < xnBands.size(); i++)
+				xnBands[i] = xn[i % param.numSamples];
+			double nsSmooth = nsPerSample([&]() {
+				for (uint32_t blk = 0; blk < numBlocks; blk++)
+					bank.processBlockSmooth(&xnBands[0], &ynBank[0], blockSize, BANK_LP);
+			}, numBlocks*blockSize);
+
+			printf("%5u bands: %u bytes/band state (%.1f KB), max error vs onePoleTPT_LP %g\n",
+				   nb, bank.getBytesPerBand(), nb*bank.getBytesPerBand()/1024.0, maxErr);
+			failed += (maxErr != 0);
+			printf("       shared input: %.3f us/sample, %.3g bands/core/ms\n", nsShared/1000, nb*1e6/nsShared);
+			printf("       per-band input: %.3f us/sample, %.3g bands/core/ms\n", nsSmooth/1000, nb*1e6/nsSmooth);
+		}
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "ML4PMT") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test parallel voice render - Moog Ladder 4-pole ))__" << endl;
+
+		printParam(param);
+
+		const uint32_t numVoices = 128;
+		const uint32_t blockSize = 64;
+		const uint32_t voicesPerChunk = 16;
+		uint32_t numCallbacks = param.numSamples/blockSize;
+		if (numCallbacks == 0) {
+			cout<<"-n "<<param.numSamples<<" is shorter than one "<<blockSize<<" sample callback"<<endl;
+			return 1;
+		}
+
+		uint32_t numCpus = thread::hardware_concurrency();
+		uint32_t numWorkers = (numCpus > 1) ? numCpus - 1 : 1;
+
+		// identical single-thread and parallel voice pools
+		xodMoogLadderVoicePool poolST, poolMT;
+		poolST.initialize(numVoices, param.sampleRate);
+		poolMT.initialize(numVoices, param.sampleRate);
+		for (uint32_t v = 0; v < numVoices; v++) {
+			float fc = param.cutoff*(1 + v % 16);
+			poolST.voice(poolST.acquire()).setFcAndRes(fc, param.resonance, param.sampleRate);
+			poolMT.voice(poolMT.acquire()).setFcAndRes(fc, param.resonance, param.sampleRate);
+		}
+
+		// the same pool at an odd render block - the mix must not change
+		xodMoogLadderVoicePool poolRB = poolST;
+		poolRB.setRenderBlock(37);
+
+		xodRTWorkerPool workers;
+		workers.initialize(numWorkers, true);
+
+		xodParallelVoiceRender renderMT;
+		renderMT.initialize(&poolMT, &workers, blockSize, voicesPerChunk);
+
+#ifdef XODVA_PROFILE
+		// the workers record into per-chunk profiles, merged after every callback
+		xodCycleProfile profST, profMT;
+		poolST.setProfile(&profST);
+		renderMT.setProfile(&profMT);
+#endif
+
+		vector<double> tST, tMT;
+		float mixST[blockSize], mixMT[blockSize], mixRB[blockSize];
+		float maxErr = 0, peak = 0;
+		uint32_t rbMismatch = 0;
+
+		for (uint32_t cb = 0; cb < numCallbacks; cb++) {
+			const float* voiceIn[numVoices];
+			for (uint32_t v = 0; v < numVoices; v++)
+				voiceIn[v] = &xn[cb*blockSize];
+
+			auto t0 = chrono::steady_clock::now();
+			poolST.processBlockMix(voiceIn, mixST, blockSize);
+			auto t1 = chrono::steady_clock::now();
+			renderMT.processBlockMix(voiceIn, mixMT, blockSize);
+			auto t2 = chrono::steady_clock::now();
+
+			tST.push_back(chrono::duration<double, micro>(t1 - t0).count());
+			tMT.push_back(chrono::duration<double, micro>(t2 - t1).count());
+
+			poolRB.processBlockMix(voiceIn, mixRB, blockSize);
+			for (uint32_t i = 0; i < blockSize; i++) {
+				maxErr = max(maxErr, fabsf(mixST[i] - mixMT[i]));
+				peak = max(peak, fabsf(mixST[i]));
+				rbMismatch += (mixRB[i] != mixST[i]);
+			}
+		}
+
+		// a block longer than maxBlockSize is rejected, never written past the chunk scratch
+		const float* voiceIn[numVoices];
+		for (uint32_t v = 0; v < numVoices; v++)
+			voiceIn[v] = xn;
+		float mixLong[2*blockSize];
+		for (uint32_t i = 0; i < 2*blockSize; i++)
+			mixLong[i] = -7.0f;
+		renderMT.processBlockMix(voiceIn, mixLong, 2*blockSize);
+		uint32_t touched = 0;
+		for (uint32_t i = 0; i < 2*blockSize; i++)
+			touched += (mixLong[i] != -7.0f);
+
+		workers.shutdown();
+
+		double budget = 1e6*blockSize/param.sampleRate;
+		cout<<numVoices<<" voices, "<<blockSize<<" sample callbacks ("<<budget<<" us budget), "
+			<<numWorkers<<" workers + audio thread on "<<numCpus<<" cpus"<<endl;
+		// the chunks only change the summation order - one float epsilon of the mix per voice
+		float tol = numVoices*1.2e-7f*max(peak, 1.0f);
+		cout<<"max |mix ST - mix MT| = "<<maxErr<<" (chunked summation order, tolerance "<<tol<<")"<<endl;
+		cout<<"render block "<<poolRB.getRenderBlock()<<" vs "<<poolST.getRenderBlock()<<": mix mismatches = "<<rbMismatch<<endl;
+		cout<<"block of "<<2*blockSize<<" > maxBlockSize: rejected = "<<(touched ? "no" : "yes")<<endl;
+		cout<<"callback latency (us)     p50       p90       p99       max"<<endl;
+		printf("  single thread      %9.2f %9.2f %9.2f %9.2f\n", percentile(tST, 50), percentile(tST, 90), percentile(tST, 99), percentile(tST, 100));
+		printf("  worker pool        %9.2f %9.2f %9.2f %9.2f\n", percentile(tMT, 50), percentile(tMT, 90), percentile(tMT, 99), percentile(tMT, 100));
+
+#ifdef XODVA_PROFILE
+		profST.dump(cout, "voice pool - single thread");
+		profMT.dump(cout, "voice pool - worker pool (merged chunk profiles)");
+		for (int s = 0; s < PROF_NUM_SECTIONS; s++)
+			touched += (profST.sec[s].getCount() != profMT.sec[s].getCount());
+#endif
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return (maxErr > tol || touched || rbMismatch) ? 1 : 0;
+
+	}
+
+	if(param.type == "WORKERS") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test real-time worker pool - varying task counts ))__" << endl;
+
+		printParam(param);
+
+		// at least 3 workers so claims contend even on a single cpu
+		uint32_t numCpus = thread::hardware_concurrency();
+		uint32_t numWorkers = (numCpus > 4) ? numCpus - 1 : 3;
+		uint32_t numRuns = param.numSamples;
+
+		xodRTWorkerPool workers;
+		workers.initialize(numWorkers, false, 0, 20);
+
+		// task counts jump up and down between consecutive runs (graph levels),
+		// plus one run larger than a batch
+		const uint32_t maxTasks = xodRTWorkerPool::maxBatch + 100;
+		workStress_t ws(maxTasks + 1);
+		uint32_t bad = 0;
+		uint64_t totalTasks = 0;
+		auto t0 = chrono::steady_clock::now();
+		for (uint32_t r = 0; r <= numRuns; r++) {
+			uint32_t n = (r == numRuns) ? maxTasks : 1 + xodRandU32(param.seed, r) % 97;
+			for (uint32_t t = 0; t <= n; t++)
+				ws.hits[t].store(0, memory_order_relaxed);
+			workers.run(workStress_t::task, &ws, n);
+			for (uint32_t t = 0; t < n; t++)
+				bad += (ws.hits[t].load(memory_order_relaxed) != 1);
+			bad += (ws.hits[n].load(memory_order_relaxed) != 0);
+			totalTasks += n;
+		}
+		double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+		workers.shutdown();
+
+		printf("%u runs, %llu tasks, %u workers + caller on %u cpus: tasks not run exactly once = %u (%.2f us/run)\n",
+			   numRuns + 1, (unsigned long long)totalTasks, numWorkers, numCpus, bad, us/(numRuns + 1));
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return bad ? 1 : 0;
+
+	}
+
+	if(param.type == "GEN") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test signal generators ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		vector<float> genBuf(param.numSamples), genChunk(param.numSamples);
+
+		// chunked / out of order fills are bit identical to one fill
+		xodGenNoise(&genBuf[0], param.numSamples, param.seed);
+		const uint32_t numChunks = 7;
+		for (int32_t ch = numChunks - 1; ch >= 0; ch--) {
+			uint32_t s0 = (uint64_t)param.numSamples*ch/numChunks;
+			uint32_t s1 = (uint64_t)param.numSamples*(ch + 1)/numChunks;
+			xodGenNoise(&genChunk[s0], s1 - s0, param.seed, s0);
+		}
+		cout<<"noise: chunked fill identical = "<<(genBuf == genChunk ? "yes" : "no")<<endl;
+		failed += (genBuf != genChunk);
+
+		double mean = 0, var = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			mean += genBuf[i];
+		mean /= param.numSamples;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			var += (genBuf[i] - mean)*(genBuf[i] - mean);
+		var /= param.numSamples;
+		cout<<"noise: mean = "<<mean<<", variance = "<<var<<" (uniform [-1, 1): 0, 0.3333)"<<endl;
+
+		// fill cost
+		double nsRand = nsPerSample([&]() {
+			for (uint32_t i = 0; i < param.numSamples; i++)
+				genBuf[i] = 2*(static_cast<float>(rand())/static_cast<float>(RAND_MAX)) - 1;
+		}, param.numSamples);
+		double nsNoise = nsPerSample([&]() {
+			xodGenNoise(&genBuf[0], param.numSamples, param.seed);
+		}, param.numSamples);
+		xodPinkNoise pink;
+		pink.initialize(param.seed);
+		double nsPink = nsPerSample([&]() {
+			pink.fill(&genBuf[0], param.numSamples);
+		}, param.numSamples);
+		double nsSweep = nsPerSample([&]() {
+			xodGenLogSweep(&genBuf[0], param.numSamples, 20, 20000, param.numSamples, param.sampleRate);
+		}, param.numSamples);
+		double nsSaw = nsPerSample([&]() {
+			xodGenSaw(&genBuf[0], param.numSamples, 110, param.sampleRate);
+		}, param.numSamples);
+
+		printf("ns/sample: rand() %.3f, noise %.3f, pink %.3f, log sweep %.3f, saw %.3f\n",
+			   nsRand, nsNoise, nsPink, nsSweep, nsSaw);
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "ML4PBATCH") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test batch coefficient recompute ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		// log spaced cutoffs 20 Hz .. Nyquist
+		const uint32_t numVoices = 1024;
+		vector<float> fc(numVoices), res(numVoices, param.resonance);
+		for (uint32_t v = 0; v < numVoices; v++)
+			fc[v] = 20*pow(0.5*param.sampleRate/20, (double)v/(numVoices - 1));
+
+		// prewarp accuracy - batch G vs double tan G, in ulp
+		float maxUlp = 0;
+		for (uint32_t v = 0; v < numVoices; v++) {
+			float gRef = onePoleTPT_calcG(fc[v], pi/param.sampleRate);
+			float g, h;
+			onePoleTPT_calcGH(fc[v]/param.sampleRate, g, h);
+			float ulp = nextafterf(gRef, 2.0f) - gRef;
+			maxUlp = max(maxUlp, fabsf(g - gRef)/ulp);
+		}
+		cout<<"G: max error vs double tan = "<<maxUlp<<" ulp"<<endl;
+		failed += (maxUlp > 4);
+
+		// ladders - scalar setFcAndRes vs batch, output over 256 samples
+		vector<xodMoogLadder4P> ldScalar(numVoices), ldBatch(numVoices);
+		vector<xodMoogLadder4P*> pBatch(numVoices);
+		for (uint32_t v = 0; v < numVoices; v++) {
+			ldScalar[v].initialize(param.sampleRate);
+			ldBatch[v].initialize(param.sampleRate);
+			pBatch[v] = &ldBatch[v];
+		}
+
+		// console output of the scalar path is suppressed for the comparison / timing
+		cout.setstate(ios::failbit);
+		for (uint32_t v = 0; v < numVoices; v++)
+			ldScalar[v].setFcAndRes(fc[v], res[v], param.sampleRate);
+		cout.clear();
+		xodMoogLadderSetFcAndResBatch(&pBatch[0], &fc[0], &res[0], numVoices);
+
+		const uint32_t cmpLen = min(param.numSamples, 256u);
+		vector<float> ynS(cmpLen), ynB(cmpLen);
+		float maxErr = 0;
+		for (uint32_t v = 0; v < numVoices; v++) {
+			ldScalar[v].advanceBlock(xn, &ynS[0], cmpLen);
+			ldBatch[v].advanceBlock(xn, &ynB[0], cmpLen);
+			for (uint32_t i = 0; i < cmpLen; i++)
+				maxErr = max(maxErr, fabsf(ynS[i] - ynB[i]));
+		}
+		cout<<"ladder output: max error scalar vs batch coefficients = "<<maxErr<<endl;
+		failed += !(maxErr < 1e-4f);
+
+		// cost per voice
+		const uint32_t reps = 200;
+		cout.setstate(ios::failbit);
+		double nsScalar = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				for (uint32_t v = 0; v < numVoices; v++)
+					ldScalar[v].setFcAndRes(fc[v], res[v], param.sampleRate);
+		}, reps*numVoices);
+		cout.clear();
+		double nsBatch = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				xodMoogLadderSetFcAndResBatch(&pBatch[0], &fc[0], &res[0], numVoices);
+		}, reps*numVoices);
+
+		// voice pool - all active, arrays by handle
+		xodMoogLadderVoicePool pool;
+		pool.initialize(numVoices, param.sampleRate);
+		for (uint32_t v = 0; v < numVoices; v++)
+			pool.acquire();
+		double nsPool = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				pool.setFcAndResBatch(&fc[0], &res[0]);
+		}, reps*numVoices);
+
+		printf("ns/voice: scalar setFcAndRes (output suppressed) %.2f, batch %.2f, voice pool batch %.2f\n",
+			   nsScalar, nsBatch, nsPool);
+
+		// multi-channel - 8 lanes per call
+		xodMoogLadder4P_MC mc;
+		mc.initialize(xodSimdLanes, param.sampleRate);
+		double nsMC = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				for (uint32_t v = 0; v + xodSimdLanes <= numVoices; v += xodSimdLanes)
+					mc.setFcAndResBatch(&fc[v], &res[v]);
+		}, reps*numVoices);
+		double nsMCScalar = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				for (uint32_t v = 0; v + xodSimdLanes <= numVoices; v += xodSimdLanes)
+					for (uint32_t ch = 0; ch < xodSimdLanes; ch++)
+						mc.setFcAndRes(ch, fc[v + ch], res[v + ch]);
+		}, reps*numVoices);
+		printf("ns/channel: %u ch setFcAndRes %.2f, setFcAndResBatch %.2f\n", xodSimdLanes, nsMCScalar, nsMC);
+
+		// filterbank - 10k bands
+		const uint32_t numBands = 10000;
+		vector<float> fcBands(numBands);
+		for (uint32_t k = 0; k < numBands; k++)
+			fcBands[k] = 20*pow(0.45*param.sampleRate/20, (double)k/(numBands - 1));
+		xodOnePoleBank bank;
+		bank.initialize(numBands, param.sampleRate);
+		double nsBank = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps/10; r++)
+				bank.setFc(&fcBands[0]);
+		}, reps/10*numBands);
+		double nsBankBatch = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps/10; r++)
+				bank.setFcBatch(&fcBands[0]);
+		}, reps/10*numBands);
+		printf("ns/band: %u band setFc %.2f, setFcBatch %.2f\n", numBands, nsBank, nsBankBatch);
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "GUARD") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test block-level blow-up guard ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t blockSize = 64;
+		uint32_t numBlocks = param.numSamples/blockSize;
+		vector<float> xg(xn, xn + numBlocks*blockSize), yg(numBlocks*blockSize), yRef(blockSize);
+
+		auto allFinite = [](const float* y, uint32_t n) {
+			return xodMaxAbsBits(y, n) < xodInfBits;
+		};
+
+		// cutoff at / above Nyquist and NaN - clamped at update time
+		bool finiteBad = true;
+		const float badFc[3] = {0.5f*param.sampleRate, 3.0f*param.sampleRate, nanf("")};
+		for (uint32_t k = 0; k < 3; k++) {
+			xodMoogLadder4P bad;
+			bad.initialize(param.sampleRate);
+			bad.setFcAndRes(badFc[k], param.resonance, param.sampleRate);
+			bad.advanceBlock(&xg[0], &yg[0], numBlocks*blockSize);
+			finiteBad = finiteBad && allFinite(&yg[0], numBlocks*blockSize) && (bad.getGuardStats().resets == 0);
+		}
+		cout<<"cutoff fs/2, 3*fs, NaN: output finite without guard resets = "<<(finiteBad ? "yes" : "no")<<endl;
+		failed += !finiteBad;
+
+		// NaN in the input of block 3 - that block is zeroed, the ladder restarts
+		// from reset state and block 4 matches a fresh ladder
+		xodMoogLadder4P MoogL4p;
+		MoogL4p.initialize(param.sampleRate);
+		MoogL4p.setFcAndRes(param.cutoff, param.resonance, param.sampleRate);
+		xg[3*blockSize + 10] = nanf("");
+		for (uint32_t b = 0; b < numBlocks; b++)
+			MoogL4p.advanceBlock(&xg[b*blockSize], &yg[b*blockSize], blockSize);
+
+		xodMoogLadder4P fresh;
+		fresh.initialize(param.sampleRate);
+		fresh.setFcAndRes(param.cutoff, param.resonance, param.sampleRate);
+		fresh.advanceBlock(&xg[4*blockSize], &yRef[0], blockSize);
+		uint32_t mismatch = 0;
+		for (uint32_t i = 0; i < blockSize; i++)
+			mismatch += (yRef[i] != yg[4*blockSize + i]);
+		cout<<"NaN input: resets = "<<MoogL4p.getGuardStats().resets<<", output finite = "
+			<<(allFinite(&yg[0], numBlocks*blockSize) ? "yes" : "no")<<", next block mismatches vs fresh ladder = "<<mismatch<<endl;
+		failed += (mismatch != 0) || !allFinite(&yg[0], numBlocks*blockSize);
+
+		// finite spike - clamped, not reset
+		xg[3*blockSize + 10] = 1.0e30f;
+		MoogL4p.clearGuardStats();
+		MoogL4p.reset();
+		for (uint32_t b = 0; b < numBlocks; b++)
+			MoogL4p.advanceBlock(&xg[b*blockSize], &yg[b*blockSize], blockSize);
+		float peak = 0;
+		for (uint32_t i = 0; i < numBlocks*blockSize; i++)
+			peak = max(peak, fabsf(yg[i]));
+		cout<<"1e30 spike: clamps = "<<MoogL4p.getGuardStats().clamps<<", resets = "<<MoogL4p.getGuardStats().resets
+			<<", peak |y| = "<<peak<<" (limit "<<xodGuardLimit<<")"<<endl;
+
+		// stereo - NaN on the right channel only, the left channel is untouched
+		xg[3*blockSize + 10] = xn[3*blockSize + 10];
+		vector<float> stereo(2*numBlocks*blockSize), left(numBlocks*blockSize);
+		for (uint32_t i = 0; i < numBlocks*blockSize; i++) {
+			stereo[2*i] = xg[i];
+			stereo[2*i + 1] = (i == 3*blockSize + 10) ? nanf("") : xg[i];
+		}
+		xodMoogLadder4P_MC MoogL4pStereo;
+		MoogL4pStereo.initialize(2, param.sampleRate);
+		MoogL4pStereo.setFcAndRes(param.cutoff, param.resonance);
+		for (uint32_t b = 0; b < numBlocks; b++)
+			MoogL4pStereo.processInterleaved(&stereo[2*b*blockSize], blockSize);
+		fresh.reset();
+		fresh.advanceBlock(&xg[0], &left[0], numBlocks*blockSize);
+		mismatch = 0;
+		for (uint32_t i = 0; i < numBlocks*blockSize; i++)
+			mismatch += (stereo[2*i] != left[i]);
+		cout<<"stereo NaN on R: resets = "<<MoogL4pStereo.getGuardStats().resets<<", output finite = "
+			<<(allFinite(&stereo[0], 2*numBlocks*blockSize) ? "yes" : "no")<<", L mismatches = "<<mismatch<<endl;
+		failed += (mismatch != 0) || !allFinite(&stereo[0], 2*numBlocks*blockSize);
+
+		// voice pool - NaN in voice 1 of block 3: only voice 1 drops out of the
+		// mix, block 3 is voice 0 + voice 2 and every block stays finite
+		xodMoogLadderVoicePool gpool;
+		gpool.initialize(4, param.sampleRate);
+		xodMoogLadder4P gref[3];
+		for (uint32_t v = 0; v < 3; v++) {
+			float fc = param.cutoff*(1 + v);
+			gpool.voice(gpool.acquire()).setFcAndRes(fc, param.resonance, param.sampleRate);
+			gref[v].initialize(param.sampleRate);
+			gref[v].setFcAndRes(fc, param.resonance, param.sampleRate);
+		}
+		vector<float> vin1(xg.begin(), xg.end()), gmix(numBlocks*blockSize), gv(blockSize);
+		vin1[3*blockSize + 10] = nanf("");
+		const float* gin[3] = {&xg[0], &vin1[0], &xg[0]};
+		mismatch = 0;
+		for (uint32_t b = 0; b < numBlocks && b <= 3; b++) {
+			const float* bin[3] = {gin[0] + b*blockSize, gin[1] + b*blockSize, gin[2] + b*blockSize};
+			gpool.processBlockMix(bin, &gmix[b*blockSize], blockSize);
+			vector<float> ref(blockSize, 0.0f);
+			for (uint32_t v = 0; v < 3; v++) {
+				gref[v].advanceBlock(bin[v], &gv[0], blockSize);
+				for (uint32_t i = 0; i < blockSize; i++)
+					ref[i] += (v == 1 && b == 3) ? 0.0f : gv[i];
+			}
+			for (uint32_t i = 0; i < blockSize; i++)
+				mismatch += (ref[i] != gmix[b*blockSize + i]);
+		}
+		cout<<"voice pool NaN on voice 1: resets = "<<gpool.getGuardStats().resets<<", mix finite = "
+			<<(allFinite(&gmix[0], 4*blockSize) ? "yes" : "no")<<", mismatches vs healthy voices = "<<mismatch<<endl;
+		failed += (mismatch != 0) || !allFinite(&gmix[0], 4*blockSize);
+
+		// guard cost per block vs the ladder itself
+		const uint32_t reps = 200;
+		double nsLadder = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				for (uint32_t b = 0; b < numBlocks; b++)
+					MoogL4p.advanceBlock(&xg[b*blockSize], &yg[b*blockSize], blockSize);
+		}, reps*numBlocks*blockSize);
+		double nsGuard = nsPerSample([&]() {
+			for (uint32_t r = 0; r < reps; r++)
+				for (uint32_t b = 0; b < numBlocks; b++)
+					MoogL4p.guardBlock(&yg[b*blockSize], blockSize);
+		}, reps*numBlocks*blockSize);
+		printf("ns/sample: ladder + guard %.3f, guard alone %.3f (%.1f%%)\n", nsLadder, nsGuard, 100*nsGuard/nsLadder);
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "TUNE") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test startup auto-tuner ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		cout<<"machine: "<<xodTuneMachineKey()<<endl;
+
+		vector<xodTuneResult> results;
+		xodTuneProfile tp;
+		auto t0 = chrono::steady_clock::now();
+		xodTuneCalibrate(tp, &results);
+		auto t1 = chrono::steady_clock::now();
+
+		printf("\n  filter   kernel      group/tile  block  ns/sample  spread\n");
+		for (size_t r = 0; r < results.size(); r++) {
+			const xodTuneResult& tr = results[r];
+			bool ladder = (tr.filter[0] == 'l');
+			const char* kn = ladder ? (tr.kernel == LADDER_VOICE ? "voice" : "lanes")
+									: (tr.kernel == ONEPOLE_OBJECT ? "object" : "bank");
+			printf("  %-8s %-11s %10u %6u %10.3f %6.1f%%\n", tr.filter, kn, tr.group, tr.block, tr.ns, 100*tr.spread);
+		}
+
+		printf("\ncalibration %.1f ms\n", chrono::duration<double, milli>(t1 - t0).count());
+		printf("ladder: %s, group %u, block %u (%.3f ns/voice sample) - voice pool block %u\n",
+			   tp.ladderKernel == LADDER_VOICE ? "voice" : "lanes", tp.ladderGroup, tp.ladderBlock, tp.nsLadder, tp.poolBlock);
+		printf("1-pole: %s, block %u, bank tile %u (%.3f ns/filter sample)\n",
+			   tp.onePoleKernel == ONEPOLE_OBJECT ? "object" : "bank", tp.onePoleBlock, tp.bankTile, tp.nsOnePole);
+
+		// a second calibration on the same machine - the picks should agree
+		// unless candidates differ by more than their spread (informational)
+		xodTuneProfile tp2;
+		xodTuneCalibrate(tp2);
+		bool samePick = tp2.ladderKernel == tp.ladderKernel && tp2.ladderGroup == tp.ladderGroup &&
+						tp2.ladderBlock == tp.ladderBlock && tp2.poolBlock == tp.poolBlock && tp2.onePoleKernel == tp.onePoleKernel &&
+						tp2.onePoleBlock == tp.onePoleBlock && tp2.bankTile == tp.bankTile;
+		printf("repeat calibration: same picks = %s (ladder %u/%u, 1-pole %u/%u/%u)\n\n", samePick ? "yes" : "no",
+			   tp2.ladderGroup, tp2.ladderBlock, tp2.onePoleKernel, tp2.onePoleBlock, tp2.bankTile);
+
+		// round trip through a profile file
+		string tunePath = param.dataPath + "xodVAFilter.tune";
+		bool saved = xodTuneSave(tunePath.c_str(), tp);
+		xodTuneProfile tl;
+		t0 = chrono::steady_clock::now();
+		bool loaded = xodTuneLoad(tunePath.c_str(), tl);
+		t1 = chrono::steady_clock::now();
+		bool same = loaded && tl.ladderKernel == tp.ladderKernel && tl.ladderGroup == tp.ladderGroup &&
+					tl.ladderBlock == tp.ladderBlock && tl.poolBlock == tp.poolBlock && tl.onePoleKernel == tp.onePoleKernel &&
+					tl.onePoleBlock == tp.onePoleBlock && tl.bankTile == tp.bankTile && tl.machine == tp.machine;
+		printf("profile %s: saved = %s, loaded = %s, identical = %s, load %.1f us\n", tunePath.c_str(),
+			   saved ? "yes" : "no", loaded ? "yes" : "no", same ? "yes" : "no",
+			   chrono::duration<double, micro>(t1 - t0).count());
+		failed += !saved || !loaded || !same;
+
+		// a profile of another machine is rejected unless pinned
+		tl.machine = "other machine";
+		xodTuneSave(tunePath.c_str(), tl);
+		xodTuneProfile tx;
+		bool otherRejected = !xodTuneLoad(tunePath.c_str(), tx);
+		bool otherPinned = xodTuneLoad(tunePath.c_str(), tx, false);
+		cout<<"other machine profile: rejected = "<<(otherRejected ? "yes" : "no")<<", loads pinned = "<<(otherPinned ? "yes" : "no")<<endl;
+		failed += !otherRejected || !otherPinned;
+
+		// first-use profile - XODVA_TUNE = defaults / calibrate / <path>
+		const char* ov = getenv("XODVA_TUNE");
+		t0 = chrono::steady_clock::now();
+		const xodTuneProfile& tg = xodTuneGet();
+		t1 = chrono::steady_clock::now();
+		printf("xodTuneGet (XODVA_TUNE = %s): %s, %.1f ms - ladder %s/%u/%u, 1-pole %s/%u/%u\n",
+			   ov ? ov : "unset", tg.source.c_str(), chrono::duration<double, milli>(t1 - t0).count(),
+			   tg.ladderKernel == LADDER_VOICE ? "voice" : "lanes", tg.ladderGroup, tg.ladderBlock,
+			   tg.onePoleKernel == ONEPOLE_OBJECT ? "object" : "bank", tg.onePoleBlock, tg.bankTile);
+		if (!ov)
+			cout<<"  profile file: "<<xodTuneDefaultPath()<<endl;
+
+		// xodTuneGet applied the profile - objects initialized from now on use it
+		xodOnePoleBank tunedBank;
+		tunedBank.initialize(256, param.sampleRate);
+		xodMoogLadderVoicePool tunedPool;
+		tunedPool.initialize(4, param.sampleRate);
+		bool applied = tunedBank.getTileBands() == ((tg.bankTile + xodOnePoleBank::bankPad - 1)/xodOnePoleBank::bankPad)*xodOnePoleBank::bankPad &&
+					   tunedPool.getRenderBlock() == min(tg.poolBlock, xodMoogLadderVoicePool::maxRenderBlock);
+		printf("applied: bank tile %u, voice pool render block %u - matches profile = %s\n",
+			   tunedBank.getTileBands(), tunedPool.getRenderBlock(), applied ? "yes" : "no");
+		failed += !applied;
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "PIPE") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test offline read -> filter -> write pipeline ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t blockSize = 4096;
+		uint32_t len = param.numSamples;
+		float fs = param.sampleRate;
+
+		string seqIn = param.dataPath + "pipe_seq_in.dat";
+		string seqOut = param.dataPath + "pipe_seq_out.dat";
+		string pipeIn = param.dataPath + "pipe_in.dat";
+		string pipeOut = param.dataPath + "pipe_out.dat";
+		string rtOut = param.dataPath + "pipe_rt_out.dat";
+		string rtSerOut = param.dataPath + "pipe_rt_serial_out.dat";
+
+		// today: generate everything, filter, then write
+		auto t0 = chrono::steady_clock::now();
+		vector<float> x(len), y(len);
+		xodGenNoise(&x[0], len, param.seed);
+		xodMoogLadder4P ml;
+		ml.initialize(fs);
+		ml.setFcAndRes(param.cutoff, param.resonance, fs);
+		ml.advanceBlock(&x[0], &y[0], len);
+		FILE* fIn = fopen(seqIn.c_str(), "w");
+		FILE* fOut = fopen(seqOut.c_str(), "w");
+		if (!fIn || !fOut) {
+			cout<<"cannot open "<<seqIn<<" / "<<seqOut<<endl;
+			return 1;
+		}
+		for (uint32_t i = 0; i < len; i++) {
+			fprintf(fIn, "%10.7f\n", x[i]);
+			fprintf(fOut, "%10.7f\n", y[i]);
+		}
+		fclose(fIn);
+		fclose(fOut);
+		double nsSeq = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+
+		// pipeline: noise blocks -> ladder -> .dat, triple buffered
+		xodBlockPipeline pipe;
+		pipe.initialize(1, 1, blockSize, 3);
+		pipeNoise_t gen = {param.seed, 0, len};
+		ml.initialize(fs);
+		ml.setFcAndRes(param.cutoff, param.resonance, fs);
+		xodPipeTextOut wr;
+		wr.fileIn.push_back(fopen(pipeIn.c_str(), "w"));
+		wr.fileOut.push_back(fopen(pipeOut.c_str(), "w"));
+		bool ok = pipe.run(pipeNoise_t::read, &gen, pipeLadder, &ml, xodPipeTextOut::write, &wr);
+		fclose(wr.fileIn[0]);
+		fclose(wr.fileOut[0]);
+		xodPipeStats st = pipe.getStats();
+
+		bool same = readFileBytes(seqIn) == readFileBytes(pipeIn) && readFileBytes(seqOut) == readFileBytes(pipeOut);
+		printf("noise -> ladder -> .dat, %u samples: %s, %llu blocks, files identical to sequential = %s\n",
+			   len, ok ? "ok" : "FAILED", (unsigned long long)st.blocks, same ? "yes" : "no");
+		failed += !ok || !same;
+		printf("  ms: sequential %.1f, pipelined %.1f (stages: gen %.1f, filter %.1f, write %.1f)\n",
+			   nsSeq*1e-6, st.nsTotal*1e-6, st.nsRead*1e-6, st.nsFilter*1e-6, st.nsWrite*1e-6);
+		printf("  stalls: reader %u, filter %u, writer %u - max slots in flight %u of %u\n",
+			   st.readStalls, st.filterStalls, st.writeStalls, st.maxInFlight, pipe.getNumSlots());
+
+		// .dat reader -> ladder -> .dat: pipelined vs serial, double buffered
+		xodBlockPipeline pipe2;
+		pipe2.initialize(1, 1, blockSize, 2);
+		const string* rtPath[2] = {&rtOut, &rtSerOut};
+		xodPipeStats st2[2];
+		for (uint32_t k = 0; k < 2; k++) {
+			xodPipeTextIn rd;
+			rd.file.push_back(fopen(pipeIn.c_str(), "r"));
+			xodPipeTextOut rw;
+			rw.fileIn.push_back(0);
+			rw.fileOut.push_back(fopen(rtPath[k]->c_str(), "w"));
+			ml.initialize(fs);
+			ml.setFcAndRes(param.cutoff, param.resonance, fs);
+			if (k == 0)
+				pipe2.run(xodPipeTextIn::read, &rd, pipeLadder, &ml, xodPipeTextOut::write, &rw);
+			else
+				pipe2.runSerial(xodPipeTextIn::read, &rd, pipeLadder, &ml, xodPipeTextOut::write, &rw);
+			fclose(rd.file[0]);
+			fclose(rw.fileOut[0]);
+			st2[k] = pipe2.getStats();
+		}
+		printf(".dat -> ladder -> .dat: %llu samples, pipelined == serial = %s - ms: serial %.1f, pipelined %.1f\n",
+			   (unsigned long long)st2[0].samples, readFileBytes(rtOut) == readFileBytes(rtSerOut) ? "yes" : "no",
+			   st2[1].nsTotal*1e-6, st2[0].nsTotal*1e-6);
+		failed += (readFileBytes(rtOut) != readFileBytes(rtSerOut));
+
+		// backpressure - slow writer: the reader stalls, never more than numSlots blocks buffered
+		pipeNoise_t genBP = {param.seed, 0, 64*1024};
+		pipeFailWriter_t slowWr = {0, 0xffffffffu, 200};
+		xodBlockPipeline pipe3;
+		pipe3.initialize(1, 1, 1024, 3);
+		pipe3.run(pipeNoise_t::read, &genBP, pipeLadder, &ml, pipeFailWriter_t::write, &slowWr);
+		printf("slow writer: %u blocks written, reader stalls %u, max slots in flight %u of %u\n",
+			   slowWr.blocks, pipe3.getStats().readStalls, pipe3.getStats().maxInFlight, pipe3.getNumSlots());
+		failed += (slowWr.blocks != 64) || (pipe3.getStats().maxInFlight > pipe3.getNumSlots());
+
+		// writer error - the job stops early and run() reports it
+		genBP.pos = 0;
+		pipeFailWriter_t failWr = {0, 5, 0};
+		ok = pipe3.run(pipeNoise_t::read, &genBP, pipeLadder, &ml, pipeFailWriter_t::write, &failWr);
+		printf("failing writer: run() = %s, blocks written %llu of 64\n", ok ? "ok" : "false",
+			   (unsigned long long)pipe3.getStats().blocks);
+		failed += ok;
+
+		// reader error - a channel ending early, a garbled or cut-off value: run() and
+		// runSerial() fail instead of passing a shorter stream
+		string badPath[2] = {param.dataPath + "pipe_bad_a.dat", param.dataPath + "pipe_bad_b.dat"};
+		const char* badB[4] = {"10 rows", "7 rows", "garbage row 5", "cut-off last value"};
+		xodBlockPipeline pipe4;
+		pipe4.initialize(2, 0, 4, 2);
+		for (uint32_t k = 0; k < 4; k++) {
+			for (uint32_t j = 0; j < 2; j++) {
+				FILE* f = fopen(badPath[j].c_str(), "w");
+				for (uint32_t i = 0; i < ((j == 1 && k == 1) ? 7u : 10u); i++) {
+					if (j == 1 && k == 2 && i == 5)
+						fprintf(f, "abc\n");
+					else
+						fprintf(f, "%10.7f\n", 0.1f*i);
+				}
+				if (j == 1 && k == 3)
+					fprintf(f, "-");
+				fclose(f);
+			}
+			bool res[2];
+			for (uint32_t m = 0; m < 2; m++) {
+				xodPipeTextIn rd;
+				rd.file.push_back(fopen(badPath[0].c_str(), "r"));
+				rd.file.push_back(fopen(badPath[1].c_str(), "r"));
+				pipeFailWriter_t nullWr = {0, 0xffffffffu, 0};
+				xodPipeFilterFn nullFilter = [](void*, const float* const*, float* const*, uint32_t) {};
+				if (m == 0)
+					res[m] = pipe4.run(xodPipeTextIn::read, &rd, nullFilter, 0, pipeFailWriter_t::write, &nullWr);
+				else
+					res[m] = pipe4.runSerial(xodPipeTextIn::read, &rd, nullFilter, 0, pipeFailWriter_t::write, &nullWr);
+				fclose(rd.file[0]);
+				fclose(rd.file[1]);
+			}
+			bool expect = (k == 0);
+			printf("reader, 10 rows + %s: run() = %s, runSerial() = %s\n", badB[k],
+				   res[0] ? "ok" : "false", res[1] ? "ok" : "false");
+			failed += (res[0] != expect) || (res[1] != expect);
+		}
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "GRAPH") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test filter graph executor ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		const uint32_t blockSize = 64;
+		uint32_t numBlocks = param.numSamples/blockSize;
+		uint32_t len = numBlocks*blockSize;
+		float fs = param.sampleRate;
+
+		// in -> LPHP -> LP: ladder A, HP: ladder B
+		// in -> SVF BP -> AP
+		// 0.5 A + 0.3 B + 0.2 AP -> out 0, ladder A -> out 1 (fan-out)
+		xodFilterGraph g;
+		int32_t gIn = g.addInput();
+		int32_t gXo = g.addOnePole(GRAPH_LPHP, fs, 300);
+		int32_t gA = g.addLadder(fs, 800, param.resonance);
+		int32_t gB = g.addLadder(fs, 3000, param.resonance);
+		int32_t gSvf = g.addSVF(fs, 1000, 4, SVF_BP);
+		int32_t gAp = g.addOnePole(GRAPH_AP, fs, 2000);
+		int32_t gMix = g.addMix(3);
+		int32_t gOut0 = g.addOutput();
+		int32_t gOut1 = g.addOutput();
+		g.connect(gIn, 0, gXo, 0);
+		g.connect(gXo, 0, gA, 0);
+		g.connect(gXo, 1, gB, 0);
+		g.connect(gIn, 0, gSvf, 0);
+		g.connect(gSvf, 0, gAp, 0);
+		g.connect(gA, 0, gMix, 0);
+		g.connect(gB, 0, gMix, 1);
+		g.connect(gAp, 0, gMix, 2);
+		g.setGain(gMix, 0, 0.5f);
+		g.setGain(gMix, 1, 0.3f);
+		g.setGain(gMix, 2, 0.2f);
+		g.connect(gMix, 0, gOut0, 0);
+		g.connect(gA, 0, gOut1, 0);
+		bool ok = g.compile(blockSize);
+
+		vector<float> y0(len), y1(len);
+		for (uint32_t b = 0; b < numBlocks; b++) {
+			const float* in[1] = {&xn[b*blockSize]};
+			float* out[2] = {&y0[b*blockSize], &y1[b*blockSize]};
+			g.process(in, out, blockSize);
+		}
+
+		// hand-wired - one temporary buffer per edge
+		onePoleTPT_LPHP xo;
+		xo.initialize_LPHP(fs);
+		xo.setFc_LPHP(300);
+		xodMoogLadder4P lA, lB;
+		lA.initialize(fs);
+		lA.setFcAndRes(800, param.resonance, fs);
+		lB.initialize(fs);
+		lB.setFcAndRes(3000, param.resonance, fs);
+		xodSVF2P bp;
+		bp.initialize_SVF(fs);
+		bp.setFcAndQ_SVF(1000, 4);
+		onePoleTPT_AP apf;
+		apf.initialize_AP(fs);
+		apf.setFc_AP(2000);
+
+		vector<float> eLP(blockSize), eHP(blockSize), eA(blockSize), eB(blockSize), eBP(blockSize), eAP(blockSize);
+		uint32_t mismatch = 0;
+		for (uint32_t b = 0; b < numBlocks; b++) {
+			const float* x = &xn[b*blockSize];
+			for (uint32_t i = 0; i < blockSize; i++)
+				xo.doFilterStage_LPHP(x[i], eLP[i], eHP[i]);
+			lA.advanceBlock(&eLP[0], &eA[0], blockSize);
+			lB.advanceBlock(&eHP[0], &eB[0], blockSize);
+			bp.processBlock_SVF(x, &eBP[0], blockSize, SVF_BP);
+			for (uint32_t i = 0; i < blockSize; i++)
+				apf.doFilterStage_AP(eBP[i], eAP[i]);
+			for (uint32_t i = 0; i < blockSize; i++) {
+				float m = 0.5f*eA[i];
+				m += 0.3f*eB[i];
+				m += 0.2f*eAP[i];
+				mismatch += (m != y0[b*blockSize + i]) + (eA[i] != y1[b*blockSize + i]);
+			}
+		}
+		cout<<"patch: compile = "<<(ok ? "ok" : "FAILED")<<", "<<g.getNumNodes()<<" nodes, "<<g.getNumEdges()<<" edges, "
+			<<g.getNumLevels()<<" levels, "<<g.getNumBuffers()<<" block buffers - mismatches vs hand-wired = "<<mismatch<<endl;
+		failed += !ok || (mismatch != 0);
+
+		// a cycle does not compile
+		xodFilterGraph gc;
+		int32_t c0 = gc.addOnePole(GRAPH_LP, fs, 1000);
+		int32_t c1 = gc.addOnePole(GRAPH_LP, fs, 1000);
+		gc.connect(c0, 0, c1, 0);
+		gc.connect(c1, 0, c0, 0);
+		bool cycleOk = gc.compile(blockSize);
+		cout<<"cycle: compile rejected = "<<(cycleOk ? "no" : "yes")<<endl;
+		failed += cycleOk;
+
+		// wide patch - numBranches x (LPHP -> LP: ladder -> AP, HP: SVF -> ladder -> mix) -> mix
+		const uint32_t numBranches = 16;
+		xodFilterGraph gw;
+		int32_t wIn = gw.addInput();
+		int32_t wMix = gw.addMix(numBranches, 1.0f/numBranches);
+		for (uint32_t k = 0; k < numBranches; k++) {
+			float fc = 100.0f*(k + 1);
+			int32_t x = gw.addOnePole(GRAPH_LPHP, fs, fc);
+			int32_t la = gw.addLadder(fs, fc, param.resonance);
+			int32_t a = gw.addOnePole(GRAPH_AP, fs, 2*fc);
+			int32_t sv = gw.addSVF(fs, 4*fc, 2, SVF_BP);
+			int32_t lb = gw.addLadder(fs, 8*fc, param.resonance);
+			int32_t m = gw.addMix(2);
+			gw.connect(wIn, 0, x, 0);
+			gw.connect(x, 0, la, 0);
+			gw.connect(la, 0, a, 0);
+			gw.connect(x, 1, sv, 0);
+			gw.connect(sv, 0, lb, 0);
+			gw.connect(a, 0, m, 0);
+			gw.connect(lb, 0, m, 1);
+			gw.connect(m, 0, wMix, k);
+		}
+		int32_t wOut = gw.addOutput();
+		gw.connect(wMix, 0, wOut, 0);
+		gw.compile(blockSize);
+		cout<<"wide patch: "<<gw.getNumNodes()<<" nodes, "<<gw.getNumEdges()<<" edges, "<<gw.getNumLevels()<<" levels - "
+			<<gw.getNumBuffers()<<" block buffers ("<<gw.getNumBuffers()*blockSize*sizeof(float)/1024.0<<" KB) vs "
+			<<gw.getNumEdges()<<" per-edge"<<endl;
+
+		vector<float> yST(len), yMT(len), yCopy(len);
+		auto runWide = [&](xodFilterGraph& gr, vector<float>& y) {
+			for (uint32_t b = 0; b < numBlocks; b++) {
+				const float* in[1] = {&xn[b*blockSize]};
+				float* out[1] = {&y[b*blockSize]};
+				gr.process(in, out, blockSize);
+			}
+		};
+
+		// same patch on the worker pool - a fresh graph so both start from reset state
+		uint32_t numCpus = thread::hardware_concurrency();
+		uint32_t numWorkers = (numCpus > 1) ? numCpus - 1 : 1;
+		xodRTWorkerPool workers;
+		workers.initialize(numWorkers, false);
+		xodFilterGraph gwMT = gw;
+		gwMT.compile(blockSize, &workers);
+		cout<<"wide patch on workers: "<<gwMT.getNumLevels()<<" levels - "<<gwMT.getNumBuffers()<<" block buffers"<<endl;
+
+		// a copy of a compiled graph runs on its own buffers without compile()
+		xodFilterGraph gwCopy = gw;
+
+		double nsST = nsPerSample([&]() {runWide(gw, yST);}, len);
+		double nsMT = nsPerSample([&]() {runWide(gwMT, yMT);}, len);
+		mismatch = 0;
+		for (uint32_t i = 0; i < len; i++)
+			mismatch += (yST[i] != yMT[i]);
+		printf("wide patch ns/sample: single thread %.1f, %u workers + caller %.1f - mismatches = %u\n",
+			   nsST, numWorkers, nsMT, mismatch);
+		failed += (mismatch != 0);
+
+		runWide(gwCopy, yCopy);
+		mismatch = 0;
+		for (uint32_t i = 0; i < len; i++)
+			mismatch += (yST[i] != yCopy[i]);
+		cout<<"copied compiled graph: mismatches vs original = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// invalid node ids are ignored by the controls
+		gw.setFc(xodFilterGraph::noNode, 1000);
+		gw.setFcAndRes((int32_t)gw.getNumNodes(), 1000, 0.5f);
+		gw.setFcAndQ(-7, 1000, 1);
+		gw.setGain((int32_t)gw.getNumNodes() + 3, 0, 1);
+		workers.shutdown();
+
+		(void)gOut0; (void)gOut1;
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
+
+	}
+
+	if(param.type == "CAPI") {
+
+		// *---------------------------------------------------------------------------* //
+		cout << "__(( test C ABI ))__" << endl;
+
+		printParam(param);
+
+		uint32_t failed = 0;
+
+		cout<<"ABI version "<<xodva_abi_version()<<endl;
+
+		// every wrapper must be bit identical to the C++ object it wraps
+		vector<float> ynRef(param.numSamples), ynC(param.numSamples);
+		uint32_t mismatch;
+
+		// mono ladder
+		xodMoogLadder4P MoogL4p;
+		MoogL4p.initialize(param.sampleRate);
+		MoogL4p.setFcAndRes(param.cutoff, param.resonance, param.sampleRate);
+		MoogL4p.advanceBlock(xn, &ynRef[0], param.numSamples);
+
+		xodvaLadder* cLadder = xodva_ladder_create(param.sampleRate);
+		xodva_ladder_set_fc_res(cLadder, param.cutoff, param.resonance);
+		xodva_ladder_process(cLadder, xn, &ynC[0], param.numSamples);
+		mismatch = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			mismatch += (ynC[i] != ynRef[i]);
+		cout<<"ladder: mismatches = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// state round trip - snapshot at the half, resume from it
+		uint32_t half = param.numSamples/2;
+		xodva_ladder_reset(cLadder);
+		xodva_ladder_process(cLadder, xn, &ynC[0], half);
+		vector<uint8_t> snap(xodva_ladder_save_state(cLadder, nullptr, 0));
+		xodva_ladder_save_state(cLadder, &snap[0], snap.size());
+		xodva_ladder_destroy(cLadder);
+
+		cLadder = xodva_ladder_create(param.sampleRate);
+		int loaded = xodva_ladder_load_state(cLadder, &snap[0], snap.size());
+		xodva_ladder_process(cLadder, &xn[half], &ynC[half], param.numSamples - half);
+		mismatch = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			mismatch += (ynC[i] != ynRef[i]);
+		cout<<"ladder: state "<<snap.size()<<" bytes, load = "<<loaded<<", resume mismatches = "<<mismatch<<endl;
+		failed += (mismatch != 0) || !loaded;
+		xodva_ladder_destroy(cLadder);
+
+		// batch coefficient update - 16 ladders, cutoff per ladder
+		const uint32_t numBatch = 16;
+		xodvaLadder* cBatch[numBatch];
+		float fcBatch[numBatch], resBatch[numBatch];
+		for (uint32_t v = 0; v < numBatch; v++) {
+			cBatch[v] = xodva_ladder_create(param.sampleRate);
+			fcBatch[v] = param.cutoff*(1 + 0.25f*v);
+			resBatch[v] = param.resonance;
+		}
+		xodva_ladder_set_fc_res_batch(cBatch, fcBatch, resBatch, numBatch);
+
+		// reference is the scalar double precision setFcAndRes - the batch path
+		// prewarps in single precision (<= 4 ulp in G, see ML4PBATCH), so the
+		// outputs agree to a tolerance, not bit for bit
+		const float batchTol = 1e-4f;
+		float maxErrBatch = 0;
+		for (uint32_t v = 0; v < numBatch; v++) {
+			xodMoogLadder4P ref;
+			ref.initialize(param.sampleRate);
+			cout.setstate(ios::failbit);
+			ref.setFcAndRes(fcBatch[v], resBatch[v], param.sampleRate);
+			cout.clear();
+			ref.advanceBlock(xn, &ynRef[0], param.numSamples);
+			xodva_ladder_process(cBatch[v], xn, &ynC[0], param.numSamples);
+			for (uint32_t i = 0; i < param.numSamples; i++)
+				maxErrBatch = max(maxErrBatch, fabsf(ynC[i] - ynRef[i]));
+			xodva_ladder_destroy(cBatch[v]);
+		}
+		cout<<"ladder batch ("<<numBatch<<"): max error vs scalar setFcAndRes = "<<maxErrBatch<<" (tolerance "<<batchTol<<")"<<endl;
+		failed += !(maxErrBatch < batchTol);
+
+		// stereo interleaved
+		vector<float> ynStereoRef(2*param.numSamples), ynStereoC(2*param.numSamples);
+		for (uint32_t i = 0; i < param.numSamples; i++) {
+			ynStereoRef[2*i] = ynStereoRef[2*i + 1] = xn[i];
+			ynStereoC[2*i] = ynStereoC[2*i + 1] = xn[i];
+		}
+		xodMoogLadder4P_MC MoogL4pStereo;
+		MoogL4pStereo.initialize(2, param.sampleRate);
+		MoogL4pStereo.setFcAndRes(0, param.cutoff, param.resonance);
+		MoogL4pStereo.setFcAndRes(1, param.cutoff*2, param.resonance);
+		MoogL4pStereo.processInterleaved(&ynStereoRef[0], param.numSamples);
+
+		xodvaLadderMC* cStereo = xodva_ladder_mc_create(2, param.sampleRate);
+		xodva_ladder_mc_set_fc_res_channel(cStereo, 0, param.cutoff, param.resonance);
+		xodva_ladder_mc_set_fc_res_channel(cStereo, 1, param.cutoff*2, param.resonance);
+		xodva_ladder_mc_process_interleaved(cStereo, &ynStereoC[0], param.numSamples);
+		xodva_ladder_mc_destroy(cStereo);
+		mismatch = 0;
+		for (uint32_t i = 0; i < 2*param.numSamples; i++)
+			mismatch += (ynStereoC[i] != ynStereoRef[i]);
+		cout<<"ladder MC stereo: mismatches = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// SVF band pass
+		xodSVF2P SVF2p;
+		SVF2p.initialize_SVF(param.sampleRate);
+		SVF2p.setFcAndQ_SVF(param.cutoff, 4.0f);
+		SVF2p.processBlock_SVF(xn, &ynRef[0], param.numSamples, SVF_BP);
+
+		xodvaSVF* cSVF = xodva_svf_create(param.sampleRate);
+		xodva_svf_set_fc_q(cSVF, param.cutoff, 4.0f);
+		xodva_svf_process(cSVF, xn, &ynC[0], param.numSamples, XODVA_SVF_BP);
+		xodva_svf_destroy(cSVF);
+		mismatch = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			mismatch += (ynC[i] != ynRef[i]);
+		cout<<"SVF BP: mismatches = "<<mismatch<<endl;
+		failed += (mismatch != 0);
+
+		// voice pool - 4 voices, one released mid way
+		const uint32_t numVoices = 4;
+		xodMoogLadderVoicePool pool;
+		pool.initialize(numVoices, param.sampleRate);
+		xodvaVoicePool* cPool = xodva_pool_create(numVoices, param.sampleRate);
+		const float* voiceIn[numVoices];
+		for (uint32_t v = 0; v < numVoices; v++) {
+			voiceIn[v] = xn;
+			int32_t hRef = pool.acquire();
+			int32_t hC = xodva_pool_acquire(cPool);
+			pool.voice(hRef).setFcAndRes(param.cutoff*(v+1), param.resonance, param.sampleRate);
+			xodva_pool_set_fc_res(cPool, hC, param.cutoff*(v+1), param.resonance);
+		}
+		pool.processBlockMix(voiceIn, &ynRef[0], half);
+		xodva_pool_process_mix(cPool, voiceIn, &ynC[0], half);
+		pool.release(1);
+		xodva_pool_release(cPool, 1);
+		pool.processBlockMix(voiceIn, &ynRef[half], param.numSamples - half);
+		xodva_pool_process_mix(cPool, voiceIn, &ynC[half], param.numSamples - half);
+		mismatch = 0;
+		for (uint32_t i = 0; i < param.numSamples; i++)
+			mismatch += (ynC[i] != ynRef[i]);
+		cout<<"voice pool: active = "<<xodva_pool_num_active(cPool)<<", mismatches = "<<mismatch<<endl;
+		failed += (mismatch != 0) || (xodva_pool_num_active(cPool) != numVoices - 1);
+		xodva_pool_destroy(cPool);
+
+		// invalid arguments - no object
+		bool nullOk = !xodva_ladder_create(0) && !xodva_ladder_mc_create(xodSimdLanes + 1, param.sampleRate) &&
+					  !xodva_onepole_create(7, param.sampleRate) &&
+					  !xodva_bank_create(xodOnePoleBank::maxBands + 1, param.sampleRate) &&
+					  !xodva_bank_create(0xffffffffu, param.sampleRate);
+		cout<<"invalid create returns NULL = "<<(nullOk ? "yes" : "no")<<endl;
+		failed += !nullOk;
+
+		cout<<endl<<"***** Test complete *****"<<endl;
+		return failed ? 1 : 0;
 
 	}
 
@@ -0,0 +1,513 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_tune.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 startup auto-tuner - kernel variant / block size per machine
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "xodVAFilter_base.h"
+#include "xodVAFilter.h"
+#include "xodVAFilter_bank.h"
+#include "xodVAFilter_voicePool.h"
+#include "xodVAFilter_gen.h"
+#include "xodVAFilter_tune.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Auto-tuner ---* //
+
+static const uint32_t tuneVersion = 2;
+
+// benchmark shapes - small enough that a full calibration stays around two
+// seconds, large enough that the working set is realistic (32 voices, 2k bands)
+static const float tuneSampleRate = 48000;
+static const uint32_t tuneRounds = 7;		// sweeps over all candidates
+static const uint32_t tuneRepeats = 2;		// runs per candidate per sweep - best of
+
+static const uint32_t tuneVoices = 32;
+static const uint32_t tuneLadderLen = 4096;
+static const uint32_t tuneLadderGroups[] = {1, 2, 4, 8};			// 1 = LADDER_VOICE
+static const uint32_t tuneNumLadderGroups = 4;
+
+static const uint32_t tuneBands = 2048;
+static const uint32_t tuneOnePoleLen = 1024;
+static const uint32_t tuneTiles[] = {128, 256, 512, 1024, 2048};
+static const uint32_t tuneNumTiles = 5;
+
+static const uint32_t tuneBlocks[] = {32, 64, 128, 256, 512};
+static const uint32_t tuneNumBlocks = 5;
+
+// the pick is the first candidate (smallest block / group / tile) whose median
+// is within the margin of the fastest median. the margin is tuneSpreadFactor x
+// the measured spread, at least tuneMinMargin, so two calibrations on the same
+// machine only disagree when candidates differ by more than their run-to-run
+// noise. capped at tuneMaxMargin - a very noisy machine never trades away more
+// than that for stability
+static const float tuneMinMargin = 0.05f;
+static const float tuneMaxMargin = 0.15f;
+static const float tuneSpreadFactor = 2.0f;
+
+struct tuneTiming_t {
+	float ns;		// median ns per unit over the rounds
+	float spread;	// (2nd highest - 2nd lowest) / median of the rounds
+};
+
+// best of tuneRepeats - ns per unit (voice sample / filter sample)
+// prep runs untimed before every repeat (restores in-place buffers)
+template<class P, class F>
+static float tuneBestNs(P prep, F run, uint64_t units) {
+	double best = 0;
+	for (uint32_t r = 0; r < tuneRepeats; r++) {
+		prep();
+		auto t0 = std::chrono::steady_clock::now();
+		run();
+		auto t1 = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+		if (r == 0 || ns < best)
+			best = ns;
+	}
+	return (float)(best/units);
+}
+
+// one candidate over the rounds. the rounds sweep every candidate in turn,
+// so a burst of noise (another process, a frequency change) lands in one
+// round of many candidates instead of all runs of one
+static tuneTiming_t tuneSummarize(std::vector<float> t) {
+	std::sort(t.begin(), t.end());
+	float med = t[t.size()/2];
+	tuneTiming_t tt = {med, (t[t.size() - 2] - t[1])/med};
+	return tt;
+}
+
+// index of the pick among candidates in preference order - the margin of a
+// candidate covers its own spread and that of the fastest
+static uint32_t tunePick(const std::vector<tuneTiming_t>& c) {
+	uint32_t fastest = 0;
+	for (uint32_t i = 1; i < c.size(); i++) {
+		if (c[i].ns < c[fastest].ns)
+			fastest = i;
+	}
+	for (uint32_t i = 0; i < fastest; i++) {
+		float margin = tuneSpreadFactor*std::max(c[i].spread, c[fastest].spread);
+		margin = std::min(tuneMaxMargin, std::max(tuneMinMargin, margin));
+		if (c[i].ns <= (1 + margin)*c[fastest].ns)
+			return i;
+	}
+	return fastest;
+}
+
+static uint64_t tuneFNV1a(const std::string& s) {
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < s.size(); i++) {
+		h ^= (uint8_t)s[i];
+		h *= 0x100000001b3ull;
+	}
+	return h;
+}
+
+
+// CPU model / hardware threads / ISA of this build
+std::string xodTuneMachineKey() {
+
+	std::string cpu = "unknown cpu";
+	std::ifstream f("/proc/cpuinfo");
+	std::string line;
+	while (std::getline(f, line)) {
+		if (line.compare(0, 10, "model name") == 0 || line.compare(0, 9, "Processor") == 0) {
+			size_t c = line.find(':');
+			if (c != std::string::npos) {
+				size_t b = line.find_first_not_of(" \t", c + 1);
+				if (b != std::string::npos)
+					cpu = line.substr(b);
+			}
+			break;
+		}
+	}
+
+#if defined(__AVX512F__)
+	const char* isa = "avx512";
+#elif defined(__AVX2__)
+	const char* isa = "avx2";
+#elif defined(__AVX__)
+	const char* isa = "avx";
+#elif defined(__SSE2__)
+	const char* isa = "sse2";
+#elif defined(__ARM_NEON)
+	const char* isa = "neon";
+#else
+	const char* isa = "generic";
+#endif
+
+	std::ostringstream key;
+	key<<cpu<<" / "<<std::thread::hardware_concurrency()<<" threads / "<<isa;
+	return key.str();
+
+}
+
+std::string xodTuneDefaultPath() {
+	char hash[24];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)tuneFNV1a(xodTuneMachineKey()));
+	const char* home = getenv("HOME");
+	std::string dir = (home && *home) ? std::string(home) + "/" : std::string();
+	return dir + ".xodvafilter-" + hash + ".tune";
+}
+
+// the pre-tuner behaviour: voice pool ladders, 64 sample blocks, bank tiles of tileBands
+void xodTuneDefaults(xodTuneProfile& p) {
+	p.ladderKernel = LADDER_VOICE;
+	p.ladderGroup = 1;
+	p.ladderBlock = 64;
+	p.poolBlock = 64;
+	p.onePoleKernel = ONEPOLE_BANK;
+	p.onePoleBlock = 64;
+	p.bankTile = xodOnePoleBank::tileBands;
+	p.nsLadder = 0;
+	p.nsOnePole = 0;
+	p.machine = xodTuneMachineKey();
+	p.source = "defaults";
+}
+
+
+// *---------------------------------------------------------------------------* //
+// calibration
+
+// tuneVoices ladders, in place over per-voice buffers, rendered block by
+// block (every voice per block - as in an audio callback)
+static float tuneLadder(uint32_t group, uint32_t block, const std::vector<float>& xn, std::vector<float>& buf) {
+
+	uint32_t n = tuneLadderLen;
+	auto prep = [&]() {
+		for (uint32_t v = 0; v < tuneVoices; v++)
+			memcpy(&buf[(size_t)v*n], &xn[0], n*sizeof(float));
+	};
+
+	if (group == 1) {
+		std::vector<xodMoogLadder4P> voices(tuneVoices);
+		std::vector<xodMoogLadder4P*> pv(tuneVoices);
+		std::vector<float> fc(tuneVoices), res(tuneVoices, 1.0f);
+		for (uint32_t v = 0; v < tuneVoices; v++) {
+			voices[v].initialize(tuneSampleRate);
+			pv[v] = &voices[v];
+			fc[v] = 200.0f*(v + 1);
+		}
+		xodMoogLadderSetFcAndResBatch(&pv[0], &fc[0], &res[0], tuneVoices);
+
+		return tuneBestNs(prep, [&]() {
+			for (uint32_t pos = 0; pos < n; pos += block)
+				for (uint32_t v = 0; v < tuneVoices; v++) {
+					float* y = &buf[(size_t)v*n + pos];
+					voices[v].advanceBlock(y, y, block);
+				}
+		}, (uint64_t)tuneVoices*n);
+	}
+
+	uint32_t numGroups = tuneVoices/group;
+	std::vector<xodMoogLadder4P_MC> groups(numGroups);
+	for (uint32_t g = 0; g < numGroups; g++) {
+		float fc[xodSimdLanes], res[xodSimdLanes];
+		for (uint32_t ch = 0; ch < group; ch++) {
+			fc[ch] = 200.0f*(g*group + ch + 1);
+			res[ch] = 1.0f;
+		}
+		groups[g].initialize(group, tuneSampleRate);
+		groups[g].setFcAndResBatch(fc, res);
+	}
+
+	return tuneBestNs(prep, [&]() {
+		float* chan[xodSimdLanes];
+		for (uint32_t pos = 0; pos < n; pos += block)
+			for (uint32_t g = 0; g < numGroups; g++) {
+				for (uint32_t ch = 0; ch < group; ch++)
+					chan[ch] = &buf[(size_t)(g*group + ch)*n + pos];
+				groups[g].processPlanar(chan, block);
+			}
+	}, (uint64_t)tuneVoices*n);
+
+}
+
+// tuneBands LP filters on a shared input - tile 0 = onePoleTPT_LP objects
+// (copies of proto - the cost does not depend on the cutoff)
+static float tuneOnePole(uint32_t tile, uint32_t block, const onePoleTPT_LP& proto,
+						 const std::vector<float>& xn, std::vector<float>& buf) {
+
+	uint32_t n = tuneOnePoleLen;
+	std::vector<float> fc(tuneBands);
+	for (uint32_t k = 0; k < tuneBands; k++)
+		fc[k] = 20.0f + 20.0f*k;
+
+	if (tile == 0) {
+		std::vector<onePoleTPT_LP> flt(tuneBands, proto);
+		return tuneBestNs([]() {}, [&]() {
+			for (uint32_t pos = 0; pos < n; pos += block)
+				for (uint32_t k = 0; k < tuneBands; k++) {
+					float* y = &buf[(size_t)k*block];
+					for (uint32_t i = 0; i < block; i++)
+						flt[k].doFilterStage_LP(xn[pos + i], y[i]);
+				}
+		}, (uint64_t)tuneBands*n);
+	}
+
+	xodOnePoleBank bank;
+	bank.initialize(tuneBands, tuneSampleRate);
+	bank.setFc(&fc[0]);
+	bank.setTileBands(tile);
+	return tuneBestNs([]() {}, [&]() {
+		for (uint32_t pos = 0; pos < n; pos += block)
+			bank.processBlock(&xn[pos], &buf[0], block, BANK_LP);
+	}, (uint64_t)tuneBands*n);
+
+}
+
+void xodTuneCalibrate(xodTuneProfile& p, std::vector<xodTuneResult>* results) {
+
+	xodTuneDefaults(p);
+	p.source = "calibrated";
+
+	std::vector<float> xn(tuneLadderLen);
+	xodGenNoise(&xn[0], tuneLadderLen, 1);
+
+	std::vector<float> buf((size_t)tuneVoices*tuneLadderLen);
+	std::vector<float> bufBank((size_t)tuneBlocks[tuneNumBlocks - 1]*tuneBands);
+
+	// candidates in preference order - ladder: group width x block,
+	// 1-pole: objects (tile 0) then bank tiles x block
+	std::vector<uint32_t> lGroup, lBlock, oTile, oBlock;
+	for (uint32_t gi = 0; gi < tuneNumLadderGroups; gi++)
+		for (uint32_t bi = 0; bi < tuneNumBlocks; bi++) {
+			lGroup.push_back(tuneLadderGroups[gi]);
+			lBlock.push_back(tuneBlocks[bi]);
+		}
+	for (uint32_t ti = 0; ti <= tuneNumTiles; ti++)
+		for (uint32_t bi = 0; bi < tuneNumBlocks; bi++) {
+			oTile.push_back((ti == 0) ? 0 : tuneTiles[ti - 1]);
+			oBlock.push_back(tuneBlocks[bi]);
+		}
+
+	onePoleTPT_LP proto;
+	proto.initialize_LP(tuneSampleRate);
+	proto.setFc_LP(1000);
+
+	std::vector<std::vector<float> > lNs(lGroup.size()), oNs(oTile.size());
+	for (uint32_t round = 0; round < tuneRounds; round++) {
+		for (uint32_t c = 0; c < lGroup.size(); c++)
+			lNs[c].push_back(tuneLadder(lGroup[c], lBlock[c], xn, buf));
+		for (uint32_t c = 0; c < oTile.size(); c++)
+			oNs[c].push_back(tuneOnePole(oTile[c], oBlock[c], proto, xn, bufBank));
+	}
+
+	std::vector<tuneTiming_t> tl, to;
+	for (uint32_t c = 0; c < lGroup.size(); c++) {
+		tl.push_back(tuneSummarize(lNs[c]));
+		if (results) {
+			xodTuneResult r = {"ladder", (lGroup[c] == 1) ? (uint32_t)LADDER_VOICE : (uint32_t)LADDER_LANES,
+							   lGroup[c], lBlock[c], tl[c].ns, tl[c].spread};
+			results->push_back(r);
+		}
+	}
+	for (uint32_t c = 0; c < oTile.size(); c++) {
+		to.push_back(tuneSummarize(oNs[c]));
+		if (results) {
+			xodTuneResult r = {"1-pole", (oTile[c] == 0) ? (uint32_t)ONEPOLE_OBJECT : (uint32_t)ONEPOLE_BANK,
+							   oTile[c], oBlock[c], to[c].ns, to[c].spread};
+			results->push_back(r);
+		}
+	}
+
+	uint32_t k = tunePick(tl);
+	p.nsLadder = tl[k].ns;
+	p.ladderKernel = (lGroup[k] == 1) ? LADDER_VOICE : LADDER_LANES;
+	p.ladderGroup = lGroup[k];
+	p.ladderBlock = lBlock[k];
+
+	// the voice pool runs xodMoogLadder4P per voice - its block is picked
+	// among the LADDER_VOICE candidates (the first tuneNumBlocks)
+	std::vector<tuneTiming_t> tv(tl.begin(), tl.begin() + tuneNumBlocks);
+	p.poolBlock = lBlock[tunePick(tv)];
+
+	k = tunePick(to);
+	p.nsOnePole = to[k].ns;
+	p.onePoleKernel = (oTile[k] == 0) ? ONEPOLE_OBJECT : ONEPOLE_BANK;
+	p.onePoleBlock = oBlock[k];
+	if (oTile[k])
+		p.bankTile = oTile[k];
+
+}
+
+
+// *---------------------------------------------------------------------------* //
+// profile file
+
+// written to a temp file and renamed - concurrent first runs never see a
+// partial profile. the temp name is unique per process and call, so two
+// writers never share (and truncate) one temp file
+bool xodTuneSave(const char* path, const xodTuneProfile& p) {
+
+	static std::atomic<uint32_t> saveCount(0);
+#if defined(__unix__) || defined(__APPLE__)
+	unsigned long pid = (unsigned long)getpid();
+#else
+	unsigned long pid = (unsigned long)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	char suffix[48];
+	snprintf(suffix, sizeof(suffix), ".%lu.%u.tmp", pid, saveCount.fetch_add(1));
+	std::string tmp = std::string(path) + suffix;
+	FILE* f = fopen(tmp.c_str(), "w");
+	if (!f)
+		return false;
+
+	fprintf(f, "# xodVAFilter tune profile - see xodVAFilter_tune.h\n");
+	fprintf(f, "version %u\n", tuneVersion);
+	fprintf(f, "machine %s\n", p.machine.c_str());
+	fprintf(f, "ladderKernel %u\n", p.ladderKernel);
+	fprintf(f, "ladderGroup %u\n", p.ladderGroup);
+	fprintf(f, "ladderBlock %u\n", p.ladderBlock);
+	fprintf(f, "poolBlock %u\n", p.poolBlock);
+	fprintf(f, "onePoleKernel %u\n", p.onePoleKernel);
+	fprintf(f, "onePoleBlock %u\n", p.onePoleBlock);
+	fprintf(f, "bankTile %u\n", p.bankTile);
+	fprintf(f, "nsLadder %.4f\n", p.nsLadder);
+	fprintf(f, "nsOnePole %.4f\n", p.nsOnePole);
+
+	bool ok = (fclose(f) == 0);
+	if (ok)
+		ok = (rename(tmp.c_str(), path) == 0);
+	if (!ok)
+		remove(tmp.c_str());
+	return ok;
+
+}
+
+bool xodTuneLoad(const char* path, xodTuneProfile& p, bool checkMachine) {
+
+	std::ifstream f(path);
+	if (!f)
+		return false;
+
+	xodTuneProfile t;
+	xodTuneDefaults(t);
+	t.machine.clear();
+	uint32_t version = 0;
+	uint32_t fields = 0;
+
+	std::string line;
+	while (std::getline(f, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream ls(line);
+		std::string key;
+		ls>>key;
+		if (key == "version") {
+			ls>>version;
+		} else if (key == "machine") {
+			std::getline(ls >> std::ws, t.machine);
+		} else if (key == "ladderKernel") {
+			ls>>t.ladderKernel; fields++;
+		} else if (key == "ladderGroup") {
+			ls>>t.ladderGroup; fields++;
+		} else if (key == "ladderBlock") {
+			ls>>t.ladderBlock; fields++;
+		} else if (key == "poolBlock") {
+			ls>>t.poolBlock; fields++;
+		} else if (key == "onePoleKernel") {
+			ls>>t.onePoleKernel; fields++;
+		} else if (key == "onePoleBlock") {
+			ls>>t.onePoleBlock; fields++;
+		} else if (key == "bankTile") {
+			ls>>t.bankTile; fields++;
+		} else if (key == "nsLadder") {
+			ls>>t.nsLadder;
+		} else if (key == "nsOnePole") {
+			ls>>t.nsOnePole;
+		}
+		if (ls.fail())
+			return false;
+	}
+
+	if (version != tuneVersion || fields != 7)
+		return false;
+	if (t.ladderKernel > LADDER_LANES || t.ladderGroup == 0 || t.ladderGroup > xodSimdLanes ||
+		t.ladderBlock == 0 || t.poolBlock == 0 || t.onePoleKernel > ONEPOLE_BANK || t.onePoleBlock == 0 || t.bankTile == 0)
+		return false;
+	if (checkMachine && t.machine != xodTuneMachineKey())
+		return false;
+
+	t.source = "file";
+	p = t;
+	return true;
+
+}
+
+
+// *---------------------------------------------------------------------------* //
+// first use
+
+static xodTuneProfile tuneInit() {
+
+	xodTuneProfile p;
+	const char* ov = getenv("XODVA_TUNE");
+	bool recalibrate = ov && !strcmp(ov, "calibrate");
+
+	if (ov && !strcmp(ov, "defaults")) {
+		xodTuneDefaults(p);
+		return p;
+	}
+
+	// pinned profile - a missing file falls back to defaults, never to a
+	// fresh (machine dependent) calibration
+	if (ov && *ov && !recalibrate) {
+		if (xodTuneLoad(ov, p, false))
+			p.source = "pinned";
+		else
+			xodTuneDefaults(p);
+		return p;
+	}
+
+	std::string path = xodTuneDefaultPath();
+	if (!recalibrate && xodTuneLoad(path.c_str(), p))
+		return p;
+
+	xodTuneCalibrate(p);
+	xodTuneSave(path.c_str(), p);
+	return p;
+
+}
+
+void xodTuneApply(const xodTuneProfile& p) {
+	xodOnePoleBank::setDefaultTileBands(p.bankTile);
+	xodMoogLadderVoicePool::setDefaultRenderBlock(p.poolBlock);
+}
+
+const xodTuneProfile& xodTuneGet() {
+	static const xodTuneProfile p = []() {
+		xodTuneProfile t = tuneInit();
+		xodTuneApply(t);
+		return t;
+	}();
+	return p;
+}
@@ -0,0 +1,125 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_tune.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 startup auto-tuner - kernel variant / block size per machine
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	xodTuneGet() returns the profile of the current machine. on first use it
+//	loads the profile file, or - when there is none for this machine -
+//	micro-benchmarks the variants (~2 s) and writes the file, then applies
+//	it (xodTuneApply) as the library defaults for objects initialized from
+//	then on:
+//
+//		bankTile     xodOnePoleBank tile (xodOnePoleBank::setDefaultTileBands)
+//		poolBlock    xodMoogLadderVoicePool render block - every voice runs
+//		             poolBlock samples before the next block, the order
+//		             measured here; also xodParallelVoiceRender's chunks
+//		             (xodMoogLadderVoicePool::setDefaultRenderBlock)
+//
+//	call it once at startup, from the setup thread. the library never calls
+//	it on its own - without it the pre-tuner defaults stay. the kernel picks
+//	(ladderKernel / ladderGroup / ladderBlock, onePoleKernel / onePoleBlock)
+//	choose between object layouts the caller builds, e.g.
+//
+//		if (tp.ladderKernel == LADDER_LANES) ... xodMoogLadder4P_MC groups of tp.ladderGroup voices
+//
+//	variants measured
+//		ladder  : xodMoogLadder4P per voice, or xodMoogLadder4P_MC lane groups
+//				  of 2 / 4 / 8 voices (planar) x render block 32 .. 512
+//		1-pole  : onePoleTPT_LP per filter, or xodOnePoleBank x block size
+//				  x bank tile 128 .. 2048 bands
+//
+//	all candidates are swept 7 times (best of 2 runs per sweep) and ranked by
+//	their median over the sweeps. the pick is the first candidate in
+//	preference order (smaller block, narrower group, smaller tile) within a
+//	margin of the fastest; the margin is the measured run-to-run spread x 2,
+//	within 5% .. 15%
+//
+//	the file is plain text (key value per line) and is keyed by the machine:
+//	CPU model, hardware threads and the ISA the library was compiled for.
+//	default location $HOME/.xodvafilter-<key hash>.tune, so hosts sharing a
+//	home directory keep separate profiles.
+//
+//	override - environment XODVA_TUNE
+//		defaults      built-in defaults, no benchmark, no file access
+//		calibrate     always re-measure and rewrite the file
+//		<path>        pinned profile - loaded as is (machine key not checked),
+//					  never rewritten; for reproducible benchmarks
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_TUNE_H__
+#define __XODVAFILTER_TUNE_H__
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Auto-tuner ---* //
+
+enum xodLadderKernel {
+	LADDER_VOICE = 0,		// xodMoogLadder4P per voice (voice pool)
+	LADDER_LANES			// xodMoogLadder4P_MC lane groups of ladderGroup voices
+};
+
+enum xodOnePoleKernel {
+	ONEPOLE_OBJECT = 0,		// onePoleTPT_* per filter
+	ONEPOLE_BANK			// xodOnePoleBank SoA, bankTile bands per tile
+};
+
+struct xodTuneProfile {
+	uint32_t ladderKernel;	// xodLadderKernel
+	uint32_t ladderGroup;	// voices per lane group (LADDER_LANES), 1 for LADDER_VOICE
+	uint32_t ladderBlock;	// samples per render block
+	uint32_t poolBlock;		// render block of the fastest LADDER_VOICE variant - voice pool
+	uint32_t onePoleKernel;	// xodOnePoleKernel
+	uint32_t onePoleBlock;	// samples per block
+	uint32_t bankTile;		// xodOnePoleBank::setTileBands
+	float nsLadder;			// ns per voice sample of the chosen ladder variant (0 = not measured)
+	float nsOnePole;		// ns per filter sample of the chosen 1-pole variant
+	std::string machine;	// key the profile was measured on
+	std::string source;		// defaults / file / calibrated / pinned
+};
+
+// one measured candidate
+struct xodTuneResult {
+	const char* filter;		// "ladder" / "1-pole"
+	uint32_t kernel;
+	uint32_t group;			// ladder group or bank tile
+	uint32_t block;
+	float ns;				// ns per voice (filter) sample - median of the repeats
+	float spread;			// relative run-to-run spread of the repeats
+};
+
+std::string xodTuneMachineKey();
+std::string xodTuneDefaultPath();
+
+void xodTuneDefaults(xodTuneProfile& p);
+void xodTuneCalibrate(xodTuneProfile& p, std::vector<xodTuneResult>* results = 0);
+
+bool xodTuneSave(const char* path, const xodTuneProfile& p);
+// false if missing, malformed, or (checkMachine) measured on another machine
+bool xodTuneLoad(const char* path, xodTuneProfile& p, bool checkMachine = true);
+
+// bankTile / poolBlock -> library defaults (see above)
+void xodTuneApply(const xodTuneProfile& p);
+
+// override / file / calibrate, then xodTuneApply - runs once, thread safe
+const xodTuneProfile& xodTuneGet();
+
+
+
+#endif // __XODVAFILTER_TUNE_H__
@@ -0,0 +1,277 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_voicePool.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 Polyphonic voice pool - fixed capacity Moog Ladder 4-pole arena
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "xodVAFilter.h"
+#include "xodVAFilter_voicePool.h"
+
+
+
+// *--------------------------------------------------------* //
+// *--- Moog Ladder 4-pole Voice Pool ---* //
+
+const int32_t xodMoogLadderVoicePool::noVoice;
+const uint32_t xodMoogLadderVoicePool::maxRenderBlock;
+std::atomic<uint32_t> xodMoogLadderVoicePool::defaultRenderBlock(64);
+
+static inline uint32_t clampRenderBlock(uint32_t samples) {
+	if (samples == 0)
+		return 1;
+	return (samples > xodMoogLadderVoicePool::maxRenderBlock) ? xodMoogLadderVoicePool::maxRenderBlock : samples;
+}
+
+void xodMoogLadderVoicePool::initialize(uint32_t maxVoices, float newSampleRate) {
+
+	capacity = maxVoices;
+	sampleRate = newSampleRate;
+	renderBlock = getDefaultRenderBlock();
+
+	voices.assign(capacity, xodMoogLadder4P());
+	slotToHandle.assign(capacity, noVoice);
+	handleToSlot.assign(capacity, noVoice);
+	freeHandles.assign(capacity, noVoice);
+
+	for (uint32_t i = 0; i < capacity; i++) {
+		voices[i].initialize(sampleRate);
+	}
+
+	releaseAll();
+
+}
+
+void xodMoogLadderVoicePool::setRenderBlock(uint32_t samples) {
+	renderBlock = clampRenderBlock(samples);
+}
+
+void xodMoogLadderVoicePool::setDefaultRenderBlock(uint32_t samples) {
+	defaultRenderBlock.store(clampRenderBlock(samples), std::memory_order_relaxed);
+}
+
+// returns a handle to a cleared voice, or noVoice when the pool is exhausted
+// the voice keeps the coefficients of its previous use - call setFcAndRes
+int32_t xodMoogLadderVoicePool::acquire() {
+
+	if (numFree == 0) {
+		return noVoice;
+	}
+
+	int32_t handle = freeHandles[--numFree];
+	uint32_t slot = numActive++;
+
+	slotToHandle[slot] = handle;
+	handleToSlot[handle] = slot;
+
+	voices[slot].reset();
+
+	return handle;
+}
+
+// swap-remove: the last active voice moves into the released slot
+void xodMoogLadderVoicePool::release(int32_t handle) {
+
+	if (!isActive(handle)) {
+		return;
+	}
+
+	uint32_t slot = handleToSlot[handle];
+	uint32_t last = --numActive;
+
+	if (slot != last) {
+		int32_t movedHandle = slotToHandle[last];
+		voices[slot] = voices[last];
+		slotToHandle[slot] = movedHandle;
+		handleToSlot[movedHandle] = slot;
+	}
+
+	slotToHandle[last] = noVoice;
+	handleToSlot[handle] = noVoice;
+	freeHandles[numFree++] = handle;
+
+}
+
+#ifdef XODVA_PROFILE
+void xodMoogLadderVoicePool::setProfile(xodCycleProfile* p) {
+	for (uint32_t i = 0; i < capacity; i++) {
+		voices[i].setProfile(p);
+	}
+}
+#endif
+
+void xodMoogLadderVoicePool::releaseAll() {
+
+	numActive = 0;
+	numFree = capacity;
+
+	// hand out low handles first
+	for (uint32_t i = 0; i < capacity; i++) {
+		slotToHandle[i] = noVoice;
+		handleToSlot[i] = noVoice;
+		freeHandles[i] = capacity - 1 - i;
+	}
+
+}
+
+void xodMoogLadderVoicePool::setGuardLimit(float limit) {
+	for (uint32_t i = 0; i < capacity; i++)
+		voices[i].setGuardLimit(limit);
+}
+
+// guard events summed over all voices (free voices keep their counts)
+xodGuardStats xodMoogLadderVoicePool::getGuardStats() const {
+	xodGuardStats gs = {0, 0};
+	for (uint32_t i = 0; i < capacity; i++) {
+		gs.resets += voices[i].getGuardStats().resets;
+		gs.clamps += voices[i].getGuardStats().clamps;
+	}
+	return gs;
+}
+
+// every active voice at once - cutoff / resonance are indexed by handle
+// gathered in slot order and handed to the vectorized batch recompute
+void xodMoogLadderVoicePool::setFcAndResBatch(const float* cutoff, const float* resonance) {
+
+	const uint32_t chunk = 64;
+	xodMoogLadder4P* v[chunk];
+	float fc[chunk];
+	float res[chunk];
+
+	for (uint32_t slot0 = 0; slot0 < numActive; slot0 += chunk) {
+		uint32_t n = (numActive - slot0 < chunk) ? numActive - slot0 : chunk;
+		for (uint32_t i = 0; i < n; i++) {
+			int32_t handle = slotToHandle[slot0 + i];
+			v[i] = &voices[slot0 + i];
+			fc[i] = cutoff[handle];
+			res[i] = resonance[handle];
+		}
+		xodMoogLadderSetFcAndResBatch(v, fc, res, n);
+	}
+
+}
+
+// in place: voiceBuf is indexed by handle, only active handles are touched
+void xodMoogLadderVoicePool::processBlock(float* const* voiceBuf, uint32_t numSamples) {
+
+	for (uint32_t slot = 0; slot < numActive; slot++) {
+		float* buf = voiceBuf[slotToHandle[slot]];
+		voices[slot].advanceBlock(buf, buf, numSamples);
+	}
+
+}
+
+// voiceIn is indexed by handle - filtered active voices are summed into mixOut
+void xodMoogLadderVoicePool::processBlockMix(const float* const* voiceIn, float* mixOut, uint32_t numSamples) {
+	processBlockMix(voiceIn, mixOut, numSamples, 0, numActive);
+}
+
+// active slots [slotBegin, slotEnd) only - disjoint ranges can render in parallel
+void xodMoogLadderVoicePool::processBlockMix(const float* const* voiceIn, float* mixOut, uint32_t numSamples,
+											 uint32_t slotBegin, uint32_t slotEnd) {
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		mixOut[i] = 0;
+	}
+
+	// every voice renders renderBlock samples into a scratch chunk before the
+	// next block (the order the tuner measures - the voices are summed in slot
+	// order either way) and is guarded on its own - a voice that blows up is
+	// reset and drops out of the mix, the others play on. scratch is on the
+	// stack so disjoint slot ranges can render in parallel
+	const uint32_t chunk = renderBlock;
+	float yv[maxRenderBlock];
+
+	for (uint32_t i0 = 0; i0 < numSamples; i0 += chunk) {
+		uint32_t n = (numSamples - i0 < chunk) ? numSamples - i0 : chunk;
+		for (uint32_t slot = slotBegin; slot < slotEnd; slot++) {
+			voices[slot].advanceBlock(voiceIn[slotToHandle[slot]] + i0, yv, n);
+			for (uint32_t i = 0; i < n; i++)
+				mixOut[i0 + i] += yv[i];
+		}
+	}
+
+}
+
+// snapshot: capacity, handle maps, then every voice in arena order
+// inactive voices are included - they keep coefficients for their next acquire
+void xodMoogLadderVoicePool::saveState(xodStateWriter& w) const {
+
+	w.put(capacity);
+	w.put(numActive);
+	w.put(numFree);
+	w.put(sampleRate);
+	w.putArray(slotToHandle.data(), capacity);
+	w.putArray(handleToSlot.data(), capacity);
+	w.putArray(freeHandles.data(), capacity);
+
+	for (uint32_t i = 0; i < capacity; i++) {
+		voices[i].saveState(w);
+	}
+
+}
+
+// loads into temporaries - the pool is only changed when the handle maps are
+// consistent: active slots and free handles partition [0, capacity) and the
+// two maps are inverses of each other
+bool xodMoogLadderVoicePool::loadState(xodStateReader& r) {
+
+	uint32_t savedCapacity = 0;
+	if (!r.get(savedCapacity) || savedCapacity != capacity)
+		return false;
+
+	uint32_t active = 0, free = 0;
+	float fs = 0;
+	std::vector<int32_t> s2h(capacity), h2s(capacity), fh(capacity);
+	if (!r.get(active) || !r.get(free) || !r.get(fs) || !r.getArray(s2h.data(), capacity)
+		|| !r.getArray(h2s.data(), capacity) || !r.getArray(fh.data(), capacity))
+		return false;
+
+	if (active > capacity || free != capacity - active || !(fs > 0))
+		return false;
+
+	std::vector<uint8_t> seen(capacity, 0);
+	for (uint32_t slot = 0; slot < active; slot++) {
+		int32_t h = s2h[slot];
+		if (h < 0 || (uint32_t)h >= capacity || seen[h] || h2s[h] != (int32_t)slot)
+			return false;
+		seen[h] = 1;
+	}
+	for (uint32_t i = 0; i < free; i++) {
+		int32_t h = fh[i];
+		if (h < 0 || (uint32_t)h >= capacity || seen[h] || h2s[h] != noVoice)
+			return false;
+		seen[h] = 1;
+	}
+
+	std::vector<xodMoogLadder4P> v(voices);
+	for (uint32_t i = 0; i < capacity; i++) {
+		if (!v[i].loadState(r))
+			return false;
+	}
+
+	numActive = active;
+	numFree = free;
+	sampleRate = fs;
+	slotToHandle.swap(s2h);
+	handleToSlot.swap(h2s);
+	freeHandles.swap(fh);
+	voices.swap(v);
+	return true;
+}
+
+// *--------------------------------------------------------* //
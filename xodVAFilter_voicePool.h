@@ -0,0 +1,121 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_voicePool.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 Polyphonic voice pool - fixed capacity Moog Ladder 4-pole arena
+//			 active voices are kept compacted at the front of the arena
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_VOICEPOOL_H__
+#define __XODVAFILTER_VOICEPOOL_H__
+
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "xodVAFilter.h"
+
+
+// *--------------------------------------------------------* //
+// *--- Moog Ladder 4-pole Voice Pool ---* //
+
+// All ladder state lives in one contiguous arena allocated by initialize().
+// Slots [0, numActive) hold the live voices, so the per-block loop only walks
+// live, cache-contiguous state. A voice is addressed by a stable handle -
+// release() swap-removes the slot with the last active slot and patches the
+// handle <-> slot maps. acquire() / release() are O(1) and never allocate.
+
+class xodMoogLadderVoicePool {
+public:
+
+	static const int32_t noVoice = -1;
+	static const uint32_t maxRenderBlock = 512;
+
+protected:
+	// voice arena - capacity ladders, active voices packed at the front
+	std::vector<xodMoogLadder4P> voices;
+
+	std::vector<int32_t> slotToHandle;		// active slot -> handle
+	std::vector<int32_t> handleToSlot;		// handle -> active slot (noVoice if free)
+	std::vector<int32_t> freeHandles;		// stack of free handles
+
+	uint32_t capacity;
+	uint32_t numActive;
+	uint32_t numFree;
+
+	float sampleRate;	// fs
+
+	// processBlockMix renders every voice renderBlock samples at a time
+	uint32_t renderBlock;
+	static std::atomic<uint32_t> defaultRenderBlock;
+
+public:
+	// allocates the arena - call from the setup thread, not the audio thread.
+	// the render block starts at the process default
+	void initialize(uint32_t maxVoices, float newSampleRate);
+
+	int32_t acquire();
+	void release(int32_t handle);
+	void releaseAll();
+
+	bool isActive(int32_t handle) const {
+		return (handle >= 0) && ((uint32_t)handle < capacity) && (handleToSlot[handle] != noVoice);
+	}
+
+	uint32_t getCapacity() const {return capacity;}
+	uint32_t getNumActive() const {return numActive;}
+	float getSampleRate() const {return sampleRate;}
+
+	// 1 .. maxRenderBlock - the mix does not depend on it
+	void setRenderBlock(uint32_t samples);
+	uint32_t getRenderBlock() const {return renderBlock;}
+	// render block of pools initialized from now on - 64, or the tuned
+	// poolBlock once xodTuneGet() has run
+	static void setDefaultRenderBlock(uint32_t samples);
+	static uint32_t getDefaultRenderBlock() {return defaultRenderBlock.load(std::memory_order_relaxed);}
+
+#ifdef XODVA_PROFILE
+	// all voices record into one bank-wide profile - single thread only; a
+	// pool rendered by xodParallelVoiceRender takes its setProfile instead
+	void setProfile(xodCycleProfile* p);
+#endif
+
+	// voice by handle (handle must be active)
+	xodMoogLadder4P& voice(int32_t handle) {return voices[handleToSlot[handle]];}
+
+	// voice by active slot [0, numActive) - slot order changes on release
+	xodMoogLadder4P& activeVoice(uint32_t slot) {return voices[slot];}
+	int32_t activeHandle(uint32_t slot) const {return slotToHandle[slot];}
+
+	// block-level blow-up guard of every voice
+	void setGuardLimit(float limit);
+	xodGuardStats getGuardStats() const;
+
+	// vectorized coefficient recompute of all active voices - indexed by handle
+	void setFcAndResBatch(const float* cutoff, const float* resonance);
+
+	void processBlock(float* const* voiceBuf, uint32_t numSamples);
+	void processBlockMix(const float* const* voiceIn, float* mixOut, uint32_t numSamples);
+	void processBlockMix(const float* const* voiceIn, float* mixOut, uint32_t numSamples,
+						 uint32_t slotBegin, uint32_t slotEnd);
+
+	// whole bank - the target pool must have been initialized with the same capacity
+	void saveState(xodStateWriter& w) const;
+	bool loadState(xodStateReader& r);
+};
+
+// *--------------------------------------------------------* //
+
+
+
+#endif // __XODVAFILTER_VOICEPOOL_H__
@@ -0,0 +1,321 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_workers.cpp))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ implementation of Virtual Analog Filters
+//			 real-time worker pool - parallel voice rendering inside one
+//			 audio callback
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "xodVAFilter_voicePool.h"
+#include "xodVAFilter_workers.h"
+
+
+
+// *---------------------------------------------------------------------------* //
+// *--- spin / futex primitives ---* //
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#else
+	std::this_thread::yield();
+#endif
+}
+
+// sleep while *word == expected
+static inline void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+#if defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, 0, 0, 0);
+#else
+	if (word.load(std::memory_order_acquire) == expected)
+		std::this_thread::yield();
+#endif
+}
+
+static inline void futexWakeAll(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 0x7fffffff, 0, 0, 0);
+#else
+	(void)word;
+#endif
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Real-time Worker Pool ---* //
+
+const uint32_t xodRTWorkerPool::maxBatch;
+
+xodRTWorkerPool::xodRTWorkerPool() : taskFn(0), taskCtx(0), taskBase(0), generation(0), work(0),
+									 tasksDone(0), numSleeping(0), quit(false), spinUs(200) {
+}
+
+xodRTWorkerPool::~xodRTWorkerPool() {
+	shutdown();
+}
+
+void xodRTWorkerPool::initialize(uint32_t numWorkers, bool pinCpus, uint32_t firstCpu, uint32_t newSpinUs) {
+
+	shutdown();
+
+	quit.store(false);
+	spinUs = newSpinUs;
+
+	for (uint32_t w = 0; w < numWorkers; w++) {
+		threads.push_back(std::thread(&xodRTWorkerPool::workerLoop, this));
+
+#if defined(__linux__)
+		if (pinCpus) {
+			uint32_t numCpus = std::thread::hardware_concurrency();
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			CPU_SET((firstCpu + 1 + w) % (numCpus ? numCpus : 1), &cpus);
+			pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpus), &cpus);
+		}
+#else
+		(void)pinCpus;
+		(void)firstCpu;
+#endif
+	}
+
+}
+
+void xodRTWorkerPool::shutdown() {
+
+	if (threads.empty())
+		return;
+
+	quit.store(true, std::memory_order_release);
+	generation.fetch_add(1, std::memory_order_release);
+	futexWakeAll(generation);
+
+	for (size_t w = 0; w < threads.size(); w++)
+		threads[w].join();
+	threads.clear();
+
+}
+
+// claim and run tasks of generation gen - false once none are left
+bool xodRTWorkerPool::runTasks(uint32_t gen) {
+
+	uint64_t v = work.load(std::memory_order_acquire);
+
+	for (;;) {
+		// generation, count and index come from one word - a stale worker
+		// can never claim a task of a newer batch
+		if ((uint32_t)(v >> 32) != gen || (uint32_t)(v & 0xffff) >= (uint32_t)((v >> 16) & 0xffff))
+			return false;
+		if (work.compare_exchange_weak(v, v + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+			break;
+	}
+
+	// the claim synchronizes with run()'s release store of work - the batch
+	// can not end (and taskFn change) before this task is counted done
+	taskFn(taskCtx, taskBase + (uint32_t)(v & 0xffff));
+	tasksDone.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+void xodRTWorkerPool::workerLoop() {
+
+	uint32_t seen = generation.load(std::memory_order_acquire);
+
+	while (!quit.load(std::memory_order_acquire)) {
+
+		// spin for spinUs, then sleep on the generation futex
+		uint32_t gen = generation.load(std::memory_order_acquire);
+		if (gen == seen) {
+			auto t0 = std::chrono::steady_clock::now();
+			uint32_t spins = 0;
+			while ((gen = generation.load(std::memory_order_acquire)) == seen) {
+				cpuRelax();
+				if ((++spins & 255) == 0 &&
+					std::chrono::steady_clock::now() - t0 > std::chrono::microseconds(spinUs)) {
+					numSleeping.fetch_add(1, std::memory_order_seq_cst);
+					futexWait(generation, seen);
+					numSleeping.fetch_sub(1, std::memory_order_acq_rel);
+					t0 = std::chrono::steady_clock::now();
+				}
+			}
+		}
+		seen = gen;
+
+		if (quit.load(std::memory_order_acquire))
+			break;
+
+		while (runTasks(gen)) {
+		}
+	}
+
+}
+
+void xodRTWorkerPool::runBatch(uint32_t base, uint32_t n) {
+
+	uint32_t gen = generation.load(std::memory_order_relaxed) + 1;
+
+	taskBase = base;
+	tasksDone.store((uint64_t)gen << 32, std::memory_order_relaxed);
+	work.store((uint64_t)gen << 32 | (uint64_t)n << 16, std::memory_order_release);
+
+	// seq_cst store / load pair with the worker's numSleeping increment - a
+	// worker about to sleep either sees the new generation or gets woken
+	generation.store(gen, std::memory_order_seq_cst);
+
+	if (numSleeping.load(std::memory_order_seq_cst) > 0)
+		futexWakeAll(generation);
+
+	// the calling thread works too
+	while (runTasks(gen)) {
+	}
+
+	// completion barrier - only claims of this generation are counted
+	const uint64_t done = (uint64_t)gen << 32 | n;
+	while (tasksDone.load(std::memory_order_acquire) != done)
+		cpuRelax();
+
+}
+
+void xodRTWorkerPool::run(xodTaskFn fn, void* ctx, uint32_t n) {
+
+	taskFn = fn;
+	taskCtx = ctx;
+	for (uint32_t base = 0; base < n; base += maxBatch)
+		runBatch(base, (n - base < maxBatch) ? n - base : maxBatch);
+
+}
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Parallel Voice Render ---* //
+
+const uint32_t xodParallelVoiceRender::maxChunks;
+
+void xodParallelVoiceRender::initialize(xodMoogLadderVoicePool* newPool, xodRTWorkerPool* newWorkers,
+										uint32_t newMaxBlockSize, uint32_t newVoicesPerChunk) {
+
+	pool = newPool;
+	workers = newWorkers;
+	maxBlockSize = newMaxBlockSize;
+	voicesPerChunk = newVoicesPerChunk ? newVoicesPerChunk : 1;
+	chunkMix.assign((size_t)maxChunks*maxBlockSize, 0.0f);
+#ifdef XODVA_PROFILE
+	prof = 0;
+	chunkProf.assign(maxChunks, xodCycleProfile());
+#endif
+
+}
+
+#ifdef XODVA_PROFILE
+void xodParallelVoiceRender::setProfile(xodCycleProfile* p) {
+	prof = p;
+	pool->setProfile(0);
+}
+
+// slots move between chunks on release - rebind every callback
+void xodParallelVoiceRender::bindChunkProfile(uint32_t chunk, uint32_t slot0, uint32_t slot1) {
+	if (!prof)
+		return;
+	for (uint32_t s = slot0; s < slot1; s++)
+		pool->activeVoice(s).setProfile(&chunkProf[chunk]);
+}
+
+void xodParallelVoiceRender::mergeChunkProfiles(uint32_t numChunks) {
+	if (!prof)
+		return;
+	for (uint32_t c = 0; c < numChunks; c++) {
+		prof->merge(chunkProf[c]);
+		chunkProf[c].reset();
+	}
+}
+#endif
+
+void xodParallelVoiceRender::renderChunk(void* ctx, uint32_t chunk) {
+
+	xodParallelVoiceRender* r = static_cast<xodParallelVoiceRender*>(ctx);
+	uint32_t slot0 = chunk*r->voicesPerChunk;
+	uint32_t slot1 = slot0 + r->voicesPerChunk;
+	if (slot1 > r->pool->getNumActive())
+		slot1 = r->pool->getNumActive();
+
+#ifdef XODVA_PROFILE
+	r->bindChunkProfile(chunk, slot0, slot1);
+#endif
+	r->pool->processBlockMix(r->voiceIn, &r->chunkMix[(size_t)chunk*r->maxBlockSize], r->numSamples, slot0, slot1);
+
+}
+
+void xodParallelVoiceRender::processBlockMix(const float* const* newVoiceIn, float* mixOut, uint32_t newNumSamples) {
+
+	if (newNumSamples > maxBlockSize)
+		return;
+
+	voiceIn = newVoiceIn;
+	numSamples = newNumSamples;
+
+	uint32_t numActive = pool->getNumActive();
+	uint32_t numChunks = (numActive + voicesPerChunk - 1)/voicesPerChunk;
+	if (numChunks > maxChunks)
+		numChunks = maxChunks;
+
+	if (numChunks <= 1) {
+#ifdef XODVA_PROFILE
+		bindChunkProfile(0, 0, numActive);
+#endif
+		pool->processBlockMix(voiceIn, mixOut, numSamples);
+#ifdef XODVA_PROFILE
+		mergeChunkProfiles(1);
+#endif
+		return;
+	}
+
+	// the last chunk picks up any voices beyond maxChunks*voicesPerChunk
+	uint32_t savedPerChunk = voicesPerChunk;
+	if (numChunks*voicesPerChunk < numActive)
+		voicesPerChunk = (numActive + numChunks - 1)/numChunks;
+
+	workers->run(renderChunk, this, numChunks);
+
+	voicesPerChunk = savedPerChunk;
+#ifdef XODVA_PROFILE
+	mergeChunkProfiles(numChunks);
+#endif
+
+	for (uint32_t i = 0; i < numSamples; i++)
+		mixOut[i] = chunkMix[i];
+	for (uint32_t c = 1; c < numChunks; c++) {
+		const float* m = &chunkMix[(size_t)c*maxBlockSize];
+		for (uint32_t i = 0; i < numSamples; i++)
+			mixOut[i] += m[i];
+	}
+
+}
+
+// *---------------------------------------------------------------------------* //
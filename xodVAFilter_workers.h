@@ -0,0 +1,144 @@
+// *===========================================================================* //
+//
+//  __::((xodVAFilter_workers.h))::__
+//
+//  ___::((XODMK Programming Industries))::___
+//  ___::((XODMK:CGBW:BarutanBreaks:djoto:2020))::___
+//
+//
+//	Purpose: C++ header for Virtual Analog Filters
+//			 real-time worker pool - parallel voice rendering inside one
+//			 audio callback
+//
+//	Revision History: Feb 08, 2017 - initial
+//	Revision History: Mar 10, 2020 - current
+//
+// *===========================================================================* //
+//
+//	workers are spawned (and optionally CPU pinned) by initialize(). run()
+//	publishes a task count, the calling thread works alongside the pool, and
+//	returns when every task is done:
+//		- tasks are claimed from one atomic word holding the generation, the
+//		  task count and the next task index - a claim is a CAS on that word,
+//		  so a worker can never pair the count of one run with the index of
+//		  another (no locks, no allocation, no std::function)
+//		- idle workers spin, then sleep on a futex (Linux) after spinUs;
+//		  run() only issues a futex wake when a worker is actually asleep
+//		- completion is a spin barrier on a generation-tagged done counter
+//		- more than maxBatch tasks run as consecutive batches
+//
+//	compile with -pthread
+//
+// *===========================================================================* //
+
+#ifndef __XODVAFILTER_WORKERS_H__
+#define __XODVAFILTER_WORKERS_H__
+
+
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "xodVAFilter_voicePool.h"
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Real-time Worker Pool ---* //
+
+typedef void (*xodTaskFn)(void* ctx, uint32_t task);
+
+class xodRTWorkerPool {
+public:
+
+	static const uint32_t maxBatch = 0xffff;	// tasks per published batch
+
+protected:
+	std::vector<std::thread> threads;
+
+	// written before the release store of work, read after a successful claim
+	xodTaskFn taskFn;
+	void* taskCtx;
+	uint32_t taskBase;					// index of task 0 of the batch
+
+	std::atomic<uint32_t> generation;	// futex word - bumped once per batch
+	std::atomic<uint64_t> work;			// generation << 32 | count << 16 | next task
+	std::atomic<uint64_t> tasksDone;	// generation << 32 | tasks finished
+	std::atomic<uint32_t> numSleeping;
+	std::atomic<bool> quit;
+
+	uint32_t spinUs;
+
+	void workerLoop();
+	bool runTasks(uint32_t gen);
+	void runBatch(uint32_t base, uint32_t n);
+
+public:
+	xodRTWorkerPool();
+	~xodRTWorkerPool();
+	xodRTWorkerPool(const xodRTWorkerPool&) = delete;
+	xodRTWorkerPool& operator=(const xodRTWorkerPool&) = delete;
+
+	// spawns numWorkers threads - pinned to cpu firstCpu+1.. when pinCpus
+	// (firstCpu is left for the audio thread). call from the setup thread
+	void initialize(uint32_t numWorkers, bool pinCpus, uint32_t firstCpu = 0, uint32_t newSpinUs = 200);
+	void shutdown();
+
+	uint32_t getNumWorkers() const {return (uint32_t)threads.size();}
+
+	// audio thread - blocks (spinning) until fn(ctx, 0..n-1) have all run
+	void run(xodTaskFn fn, void* ctx, uint32_t n);
+};
+
+
+// *---------------------------------------------------------------------------* //
+// *--- Parallel Voice Render ---* //
+
+// splits the active voices of a voice pool into chunks, renders the chunks on
+// the worker pool and sums the per-chunk mixes. scratch is preallocated.
+// profiled builds: each chunk records into its own profile, merged into the
+// target by the audio thread after the chunks have finished
+
+class xodParallelVoiceRender {
+public:
+
+	static const uint32_t maxChunks = 64;
+
+protected:
+	xodMoogLadderVoicePool* pool;
+	xodRTWorkerPool* workers;
+
+	uint32_t maxBlockSize;
+	uint32_t voicesPerChunk;
+	std::vector<float> chunkMix;		// [maxChunks][maxBlockSize]
+
+	// current callback
+	const float* const* voiceIn;
+	uint32_t numSamples;
+
+#ifdef XODVA_PROFILE
+	xodCycleProfile* prof;
+	std::vector<xodCycleProfile> chunkProf;		// [maxChunks]
+	void bindChunkProfile(uint32_t chunk, uint32_t slot0, uint32_t slot1);
+	void mergeChunkProfiles(uint32_t numChunks);
+#endif
+
+	static void renderChunk(void* ctx, uint32_t chunk);
+
+public:
+	void initialize(xodMoogLadderVoicePool* newPool, xodRTWorkerPool* newWorkers,
+					uint32_t newMaxBlockSize, uint32_t newVoicesPerChunk);
+
+#ifdef XODVA_PROFILE
+	// all voices of the pool record into p (0 = off) - setup thread
+	void setProfile(xodCycleProfile* p);
+#endif
+
+	// same contract as xodMoogLadderVoicePool::processBlockMix - numSamples <=
+	// maxBlockSize, a longer block is ignored (mixOut untouched)
+	void processBlockMix(const float* const* voiceIn, float* mixOut, uint32_t numSamples);
+};
+
+
+
+#endif // __XODVAFILTER_WORKERS_H__